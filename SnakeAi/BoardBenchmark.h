@@ -0,0 +1,98 @@
+#pragma once
+#include "Core/SnakeGame.h"
+#include "Core/AiAgent.h"
+#include "Core/WindowFeatures.h"
+#include "Core/TrainingConfig.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Measures the cost of one decision (features + network + game step) on
+ * boards of growing size, for the whole-board ray features and the egocentric
+ * window features, the latter both expanded to doubles and as packed bits.
+ * Networks are untrained; fatal moves are swapped for a safe one so games last,
+ * and time spent resetting finished games is not counted.
+ */
+class BoardBenchmark {
+public:
+    BoardBenchmark(std::vector<int> sizes, int steps) : sizes_(std::move(sizes)), steps_(steps) {}
+
+    void run() {
+        std::cout << "--- Decision cost per board size (" << steps_ << " steps each) ---" << std::endl;
+        for (int size : sizes_) {
+            const double rays = measure(size, Path::Rays);
+            const double dense = measure(size, Path::WindowDense);
+            const double bits = measure(size, Path::WindowBits);
+            char line[160];
+            std::snprintf(line, sizeof(line), "%3dx%-3d | rays+mlp %9.0f ns/step | window dense %7.0f ns/step | window bits %7.0f ns/step",
+                          size, size, rays, dense, bits);
+            std::cout << line << std::endl;
+        }
+    }
+
+private:
+    enum class Path { Rays, WindowDense, WindowBits };
+
+    double measure(int size, Path path) {
+        TrainingConfig config;
+        config.boardRows = config.boardCols = size;
+        if (path != Path::Rays) {
+            config.features = FeatureSet::Window;
+            config.layers = {{WindowObservation::INPUT_SIZE, Activation::Linear}, {128, Activation::ReLU}, {3, Activation::Linear}};
+        }
+        AiAgent agent(config, 7);
+        agent.epsilon = 0.0;
+
+        SnakeGame game(size, size);
+        game.seed(7);
+        game.reset();
+        sf::Vector2i direction = {1, 0};
+
+        using Clock = std::chrono::steady_clock;
+        Clock::duration elapsed{};
+        auto start = Clock::now();
+        for (int i = 0; i < steps_; ++i) {
+            const auto& body = game.getSnakeBody();
+            int action;
+            if (path == Path::WindowBits) {
+                action = agent.getAction(encodeWindow(game.getGrid(), body.front(), body.back(), game.getFoodPos(), direction, (int)body.size()));
+            } else {
+                const std::vector<double> state = AiAgent::getState(config.features, game.getGrid(), body.front(), body.back(),
+                                                                    game.getFoodPos(), direction, (int)body.size());
+                if (path == Path::WindowDense) {
+                    // getAction() would repack the window into bits; time the dense first layer instead
+                    const std::vector<double> q = agent.brain.feedForward(state);
+                    action = (int)(std::max_element(q.begin(), q.end()) - q.begin());
+                } else {
+                    action = agent.getAction(state);
+                }
+            }
+            sf::Vector2i move = AiAgent::toDirection(action, direction);
+            for (int a = 0; a < 3 && isFatal(game, move); ++a) move = AiAgent::toDirection(a, direction);
+            direction = move;
+
+            if (!game.step(move) || game.getFoodPos().x == -1) {
+                elapsed += Clock::now() - start;
+                game.reset();
+                direction = {1, 0};
+                start = Clock::now();
+            }
+        }
+        elapsed += Clock::now() - start;
+        return std::chrono::duration<double, std::nano>(elapsed).count() / steps_;
+    }
+
+    static bool isFatal(const SnakeGame& game, sf::Vector2i move) {
+        const auto& body = game.getSnakeBody();
+        const sf::Vector2i next = body.front() + move;
+        if (next.x < 0 || next.y < 0 || next.x >= game.getCols() || next.y >= game.getRows()) return true;
+        return game.getGrid()[next.y][next.x].type == NodeType::Snake && next != body.back();
+    }
+
+    std::vector<int> sizes_;
+    int steps_;
+};
@@ -0,0 +1,106 @@
+#include "BoardMesh.h"
+#include "Core/Config.h"
+#include <algorithm>
+
+BoardMesh::BoardMesh(int rows, int cols) : rows_(rows), cols_(cols), vertices_(sf::Triangles) {}
+
+void BoardMesh::setQuad(size_t first, sf::Vector2f p, sf::Vector2f s) {
+    vertices_[first + 0].position = {p.x, p.y};
+    vertices_[first + 1].position = {p.x + s.x, p.y};
+    vertices_[first + 2].position = {p.x + s.x, p.y + s.y};
+    vertices_[first + 3].position = {p.x, p.y};
+    vertices_[first + 4].position = {p.x + s.x, p.y + s.y};
+    vertices_[first + 5].position = {p.x, p.y + s.y};
+}
+
+void BoardMesh::setQuadColor(size_t first, sf::Color color) {
+    for (size_t i = 0; i < VERTS_PER_QUAD; ++i) vertices_[first + i].color = color;
+}
+
+sf::Color BoardMesh::colorFor(uint8_t state) {
+    switch (state) {
+        case Body: return Config::COLOR_SNAKE_BODY;
+        case Head: return Config::COLOR_SNAKE_HEAD;
+        case Food: return Config::COLOR_FOOD;
+        default:   return Config::COLOR_BG;
+    }
+}
+
+void BoardMesh::addRect(sf::Vector2f position, sf::Vector2f size, sf::Color color) {
+    const size_t first = vertices_.getVertexCount();
+    vertices_.resize(first + VERTS_PER_QUAD);
+    setQuad(first, position, size);
+    setQuadColor(first, color);
+}
+
+int BoardMesh::addBar(sf::Vector2f position, sf::Vector2f size, sf::Color background, sf::Color fill) {
+    addRect(position, size, background);
+    Bar bar;
+    bar.position = position;
+    bar.size = size;
+    bar.fillVertex = vertices_.getVertexCount();
+    addRect(position, {0.f, size.y}, fill);
+    bars_.push_back(bar);
+    return (int)bars_.size() - 1;
+}
+
+void BoardMesh::setBar(int index, float fraction) {
+    Bar& bar = bars_[index];
+    fraction = std::clamp(fraction, 0.f, 1.f);
+    if (fraction == bar.fraction) return;
+    bar.fraction = fraction;
+    setQuad(bar.fillVertex, bar.position, {bar.size.x * fraction, bar.size.y});
+}
+
+int BoardMesh::addBoard(sf::Vector2f origin, float cellSize, float padding) {
+    Board board;
+    board.origin = origin;
+    board.cellSize = cellSize;
+    board.firstVertex = vertices_.getVertexCount();
+    board.state.assign(rows_ * cols_, Unset);
+
+    vertices_.resize(board.firstVertex + (rows_ * cols_ + 1) * VERTS_PER_QUAD);
+    const sf::Vector2f cell = {cellSize - padding, cellSize - padding};
+    for (int r = 0; r < rows_; ++r) {
+        for (int c = 0; c < cols_; ++c) {
+            const size_t first = board.firstVertex + (r * cols_ + c) * VERTS_PER_QUAD;
+            setQuad(first, {origin.x + c * cellSize + padding * 0.5f, origin.y + r * cellSize + padding * 0.5f}, cell);
+            setQuadColor(first, Config::COLOR_BG);
+        }
+    }
+    // Heading marker starts collapsed (invisible)
+    const size_t marker = board.firstVertex + rows_ * cols_ * VERTS_PER_QUAD;
+    setQuad(marker, origin, {0.f, 0.f});
+    setQuadColor(marker, sf::Color::Black);
+
+    boards_.push_back(std::move(board));
+    return (int)boards_.size() - 1;
+}
+
+void BoardMesh::update(int index, const std::vector<NodeType>& cells, sf::Vector2i head, sf::Vector2i direction) {
+    Board& board = boards_[index];
+    for (int r = 0; r < rows_; ++r) {
+        for (int c = 0; c < cols_; ++c) {
+            const NodeType type = cells[r * cols_ + c];
+            uint8_t state = Empty;
+            if (type == NodeType::Snake) state = (head == sf::Vector2i(c, r)) ? Head : Body;
+            else if (type == NodeType::Food) state = Food;
+
+            uint8_t& cached = board.state[r * cols_ + c];
+            if (cached == state) continue;
+            cached = state;
+            setQuadColor(board.firstVertex + (r * cols_ + c) * VERTS_PER_QUAD, colorFor(state));
+        }
+    }
+
+    if (head != board.head || direction != board.direction) {
+        board.head = head;
+        board.direction = direction;
+        // Dark square on the head, pushed towards the heading
+        const float s = board.cellSize;
+        const float half = s * 0.2f;
+        const sf::Vector2f center = {board.origin.x + head.x * s + s * 0.5f + direction.x * (s * 0.25f),
+                                     board.origin.y + head.y * s + s * 0.5f + direction.y * (s * 0.25f)};
+        setQuad(board.firstVertex + rows_ * cols_ * VERTS_PER_QUAD, {center.x - half, center.y - half}, {half * 2.f, half * 2.f});
+    }
+}
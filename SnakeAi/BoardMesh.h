@@ -0,0 +1,61 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <vector>
+#include "Core/Node.h"
+
+/**
+ * @brief All static decoration and one or more game boards in a single
+ * persistent vertex array, drawn with one call. Cell geometry is built once;
+ * update() compares the board against what is already in the mesh and only
+ * recolours the cells that changed.
+ */
+class BoardMesh {
+public:
+    BoardMesh(int rows, int cols);
+
+    // Static rectangle (frames, backgrounds) that never changes colour
+    void addRect(sf::Vector2f position, sf::Vector2f size, sf::Color color);
+    // Adds a board whose top-left cell starts at origin; returns its index
+    int addBoard(sf::Vector2f origin, float cellSize, float padding);
+
+    // Horizontal gauge (background + fill from the left); returns its index
+    int addBar(sf::Vector2f position, sf::Vector2f size, sf::Color background, sf::Color fill);
+    void setBar(int bar, float fraction);
+
+    // cells: row-major node types of the board
+    void update(int board, const std::vector<NodeType>& cells, sf::Vector2i head, sf::Vector2i direction);
+    void draw(sf::RenderTarget& target) const { target.draw(vertices_); }
+
+private:
+    enum CellState : uint8_t { Empty, Body, Head, Food, Unset };
+
+    struct Board {
+        sf::Vector2f origin;
+        float cellSize;
+        size_t firstVertex;     // cells, then the heading marker
+        std::vector<uint8_t> state;
+        sf::Vector2i head = {-1, -1};
+        sf::Vector2i direction = {0, 0};
+    };
+
+    struct Bar {
+        sf::Vector2f position;
+        sf::Vector2f size;
+        size_t fillVertex;
+        float fraction = 0.f;
+    };
+
+    static const size_t VERTS_PER_QUAD = 6;
+
+    void setQuad(size_t first, sf::Vector2f position, sf::Vector2f size);
+    void setQuadColor(size_t first, sf::Color color);
+    static sf::Color colorFor(uint8_t state);
+
+    int rows_;
+    int cols_;
+    std::vector<Board> boards_;
+    std::vector<Bar> bars_;
+    sf::VertexArray vertices_;
+};
@@ -1,29 +1,106 @@
 #include "AiAgent.h"
 #include "Config.h"
+#include "WindowFeatures.h"
+#include "ThreadPool.h"
 #include <cmath>
 #include <algorithm>
 #include <fstream>
 #include <iostream>
 #include <queue>
 
-AiAgent::AiAgent() {
-    brain.addLayer(inputSize);
-    brain.addLayer(hiddenSize);
-    brain.addLayer(outputSize);
+AiAgent::AiAgent(const TrainingConfig& cfg, unsigned int seed) : config(cfg), rng(seed) {
+    const int inputs = stateSize(config.features);
+    if (config.layers.front().size != inputs || config.layers.back().size != ACTION_COUNT) {
+        std::cerr << "Error: Topology " << config.topologyString() << " must map " << inputs << " " << featureSetName(config.features)
+                  << " inputs to " << ACTION_COUNT << " outputs. Using the default hidden layers." << std::endl;
+        config.layers = TrainingConfig().layers;
+        config.layers.front().size = inputs;
+    }
+    buildBrain(config.layers);
     epsilon = 1.0;
 }
 
+void AiAgent::buildBrain(const std::vector<LayerSpec>& topology) {
+    brain = NeuralNetwork();
+    brain.rng.seed(rng());
+    brain.learningRate = config.learningRate;
+    for (const auto& spec : topology) brain.addLayer(spec.size, spec.activation);
+    config.layers = topology;
+}
+
+int AiAgent::stateSize(FeatureSet features) {
+    return features == FeatureSet::Window ? WindowObservation::INPUT_SIZE : STATE_SIZE;
+}
+
+std::vector<double> AiAgent::getState(FeatureSet features, const std::vector<std::vector<Node>>& grid, const sf::Vector2i& head,
+                                      const sf::Vector2i& tail, const sf::Vector2i& food, const sf::Vector2i& direction, int length) {
+    if (features == FeatureSet::Rays) return getState(grid, head, tail, food, direction);
+    std::vector<double> state;
+    encodeWindow(grid, head, tail, food, direction, length).toDense(state);
+    return state;
+}
+
+int AiAgent::getAction(const WindowObservation& window) {
+    if (std::uniform_real_distribution<double>(0.0, 1.0)(rng) < epsilon) {
+        return (int)(rng() % ACTION_COUNT);
+    }
+    std::vector<double> outputs = brain.feedForwardBits(window.bits, WindowObservation::BITS, window.extras, WindowObservation::EXTRAS);
+    if (outputs.empty()) return 0;
+    return (int)std::distance(outputs.begin(), std::max_element(outputs.begin(), outputs.end()));
+}
+
 int AiAgent::getAction(const std::vector<double>& state) {
-    if (((double)rand() / RAND_MAX) < epsilon) {
-        return rand() % outputSize;
+    if (std::uniform_real_distribution<double>(0.0, 1.0)(rng) < epsilon) {
+        return (int)(rng() % ACTION_COUNT);
     }
-    std::vector<double> outputs = brain.feedForward(state);
+    std::vector<double> outputs = qValues(state);
+    if (outputs.empty()) return 0;
     return (int)std::distance(outputs.begin(), std::max_element(outputs.begin(), outputs.end()));
 }
 
-void AiAgent::train(const std::vector<Experience>& batch) {
-    if (batch.empty()) return;
+// Window states are mostly zero bits: repacking them costs far less than the dense first layer
+std::vector<double> AiAgent::qValues(const std::vector<double>& state) {
+    if (config.features == FeatureSet::Window && state.size() == (size_t)WindowObservation::INPUT_SIZE) {
+        const WindowObservation window = WindowObservation::fromDense(state);
+        return brain.feedForwardBits(window.bits, WindowObservation::BITS, window.extras, WindowObservation::EXTRAS);
+    }
+    return brain.feedForward(state);
+}
+
+std::vector<int> AiAgent::getActions(const std::vector<double>& states, int count) {
+    std::vector<int> actions(count, 0);
+    std::vector<double> outputs;
+    if (config.features == FeatureSet::Window) {
+        // One bit-packed pass per row beats a dense batched pass over mostly zero inputs
+        const size_t stride = (size_t)WindowObservation::INPUT_SIZE;
+        if (states.size() == stride * count) {
+            outputs.reserve((size_t)count * ACTION_COUNT);
+            for (int i = 0; i < count; ++i) {
+                const std::vector<double> row(states.begin() + i * stride, states.begin() + (i + 1) * stride);
+                const std::vector<double> q = qValues(row);
+                outputs.insert(outputs.end(), q.begin(), q.end());
+            }
+        }
+    } else {
+        outputs = brain.feedForwardBatch(states, count);
+    }
+    std::uniform_real_distribution<double> coin(0.0, 1.0);
+    for (int i = 0; i < count; ++i) {
+        if (coin(rng) < epsilon) {
+            actions[i] = (int)(rng() % ACTION_COUNT);
+        } else if (!outputs.empty()) {
+            const auto first = outputs.begin() + (size_t)i * ACTION_COUNT;
+            actions[i] = (int)std::distance(first, std::max_element(first, first + ACTION_COUNT));
+        }
+    }
+    return actions;
+}
 
+double AiAgent::train(const std::vector<Experience>& batch) {
+    if (batch.empty()) return 0.0;
+    if (config.trainSlices != 1 && batch.size() > 1) return trainSliced(batch);
+
+    double squaredError = 0.0;
     for (const auto& exp : batch) {
         std::vector<double> currentQs = brain.feedForward(exp.state);
         std::vector<double> nextQs = brain.feedForward(exp.nextState);
@@ -31,20 +108,68 @@ void AiAgent::train(const std::vector<Experience>& batch) {
         
         double targetQ = exp.reward;
         if (!exp.done) {
-            targetQ += gamma * maxNextQ;
+            targetQ += config.gamma * maxNextQ;
         }
         
+        const double tdError = targetQ - currentQs[exp.action];
+        squaredError += tdError * tdError;
+        if (config.tdErrorClip > 0.0) {
+            targetQ = currentQs[exp.action] + std::clamp(tdError, -config.tdErrorClip, config.tdErrorClip);
+        }
+
         std::vector<double> targets = currentQs;
         targets[exp.action] = targetQ;
         
         brain.feedForward(exp.state); 
         brain.backPropagate(targets);
     }
+    return squaredError / batch.size();
+}
+
+// Mini-batch step: the batch is cut into slices whose gradients are computed in
+// parallel against the same weights, then summed and applied once
+double AiAgent::trainSliced(const std::vector<Experience>& batch) {
+    ThreadPool& pool = ThreadPool::shared();
+    const size_t slices = std::min(batch.size(), (size_t)(config.trainSlices > 0 ? config.trainSlices : pool.concurrency()));
+    if (slices_.size() < slices) slices_.resize(slices);
+
+    pool.parallelFor(0, slices, [&](size_t lo, size_t hi) {
+        std::vector<double> errors(ACTION_COUNT);
+        for (size_t s = lo; s < hi; ++s) {
+            TrainSlice& slice = slices_[s];
+            brain.initGradient(slice.gradient);
+            slice.squaredError = 0.0;
+            for (size_t e = batch.size() * s / slices; e < batch.size() * (s + 1) / slices; ++e) {
+                const Experience& exp = batch[e];
+                double targetQ = exp.reward;
+                if (!exp.done) {
+                    const std::vector<double>& nextQs = brain.forward(exp.nextState, slice.workspace);
+                    targetQ += config.gamma * *std::max_element(nextQs.begin(), nextQs.end());
+                }
+                const std::vector<double>& currentQs = brain.forward(exp.state, slice.workspace);
+                double tdError = targetQ - currentQs[exp.action];
+                slice.squaredError += tdError * tdError;
+                if (config.tdErrorClip > 0.0) tdError = std::clamp(tdError, -config.tdErrorClip, config.tdErrorClip);
+
+                std::fill(errors.begin(), errors.end(), 0.0);
+                errors[exp.action] = tdError;
+                brain.accumulateGradient(errors, slice.workspace, slice.gradient);
+            }
+        }
+    });
+
+    double squaredError = slices_[0].squaredError;
+    for (size_t s = 1; s < slices; ++s) {
+        slices_[0].gradient.add(slices_[s].gradient);
+        squaredError += slices_[s].squaredError;
+    }
+    brain.applyGradient(slices_[0].gradient);
+    return squaredError / batch.size();
 }
 
 void AiAgent::decayEpsilon() {
-    if (epsilon > Config::MIN_EPSILON) {
-        epsilon *= Config::EPSILON_DECAY;
+    if (epsilon > config.minEpsilon) {
+        epsilon *= config.epsilonDecay;
     }
 }
 
@@ -157,57 +282,89 @@ std::vector<double> AiAgent::getState(const std::vector<std::vector<Node>>& grid
     return state;
 }
 
-void AiAgent::save(const std::string& filename) {
-    std::string tempFilename = filename + ".tmp";
-    std::ofstream ofs(tempFilename);
-    if (!ofs.is_open()) {
-        std::cerr << "Error: Could not save model to " << tempFilename << std::endl;
-        return;
-    }
+int AiAgent::toAction(sf::Vector2i moveDir, sf::Vector2i direction) {
+    if (moveDir == sf::Vector2i(direction.y, -direction.x)) return 1; // Left
+    if (moveDir == sf::Vector2i(-direction.y, direction.x)) return 2; // Right
+    return 0;                                                         // Straight
+}
 
-    ofs << "VER2\n" << epsilon << "\n";
+sf::Vector2i AiAgent::toDirection(int action, sf::Vector2i direction) {
+    if (action == 1) return {direction.y, -direction.x};
+    if (action == 2) return {-direction.y, direction.x};
+    return direction;
+}
+
+void AiAgent::snapshot(Checkpoint& out) const {
+    out.epsilon = epsilon;
+    out.config = config;
+    out.params.resize(checkpointParamCount(config.layers));
+    double* p = out.params.data();
     for (const auto& layer : brain.layers) {
         if (layer.prevSize == 0) continue;
-        for (double b : layer.biases) ofs << b << " ";
-        ofs << "\n";
-        for (const auto& row : layer.weights) {
-            for (double w : row) ofs << w << " ";
-            ofs << "\n";
-        }
+        p = std::copy(layer.biases.begin(), layer.biases.end(), p);
+        for (const auto& row : layer.weights) p = std::copy(row.begin(), row.end(), p);
     }
-    ofs.close();
+}
 
-    // Atomic swap: This prevents other pods from reading a half-written file
-    if (std::rename(tempFilename.c_str(), filename.c_str()) != 0) {
-        std::cerr << "Error: Atomic rename failed for " << filename << std::endl;
+bool AiAgent::restore(const Checkpoint& checkpoint) {
+    const auto& stored = checkpoint.config.layers;
+    if (stored.front().size != stateSize(checkpoint.config.features) || stored.back().size != ACTION_COUNT) {
+        std::cout << "Checkpoint topology " << checkpoint.config.topologyString() << " is incompatible. Starting fresh." << std::endl;
+        return false;
     }
+    // The stored topology and feature set define the network; the other settings are kept for reference only
+    if (checkpoint.config.features != config.features) {
+        std::cout << "Checkpoint uses " << featureSetName(checkpoint.config.features) << " features" << std::endl;
+        config.features = checkpoint.config.features;
+    }
+    if (checkpoint.config.topologyString() != config.topologyString()) {
+        std::cout << "Checkpoint topology " << checkpoint.config.topologyString() << " replaces " << config.topologyString() << std::endl;
+        buildBrain(stored);
+    }
+
+    const double* p = checkpoint.params.data();
+    for (auto& layer : brain.layers) {
+        if (layer.prevSize == 0) continue;
+        std::copy(p, p + layer.size, layer.biases.begin());
+        p += layer.size;
+        for (auto& row : layer.weights) {
+            std::copy(p, p + layer.prevSize, row.begin());
+            p += layer.prevSize;
+        }
+    }
+    epsilon = checkpoint.epsilon;
+    return true;
+}
+
+void AiAgent::save(const std::string& filename) {
+    Checkpoint checkpoint;
+    snapshot(checkpoint);
+    std::string data;
+    formatCheckpoint(checkpoint, data);
+    writeFileAtomically(filename, data, true);
 }
 
-void AiAgent::load(const std::string& filename) {
+bool AiAgent::load(const std::string& filename, bool quiet) {
     std::ifstream ifs(filename);
     if (!ifs.is_open()) {
-        std::cout << "No model found at " << filename << ". Starting fresh." << std::endl;
-        return;
+        if (!quiet) std::cout << "No model found at " << filename << ". Starting fresh." << std::endl;
+        return false;
     }
 
-    std::string header;
-    ifs >> header;
-    if (header == "VER2") {
-        ifs >> epsilon;
-    } else {
+    // Parse into a separate checkpoint so a damaged file never touches the weights
+    Checkpoint checkpoint;
+    CheckpointStatus status = parseCheckpoint(ifs, checkpoint);
+    if (status == CheckpointStatus::UnknownFormat) {
         std::cout << "Old format detected. Resetting for compatibility." << std::endl;
         epsilon = 0.5;
-        ifs.close();
-        return;
+        return false;
     }
-
-    for (auto& layer : brain.layers) {
-        if (layer.prevSize == 0) continue;
-        for (int i = 0; i < layer.size; ++i) ifs >> layer.biases[i];
-        for (int i = 0; i < layer.size; ++i) {
-            for (int j = 0; j < layer.prevSize; ++j) ifs >> layer.weights[i][j];
-        }
+    if (status == CheckpointStatus::Corrupt) {
+        std::cerr << "Error: Model " << filename << " is incomplete or corrupt." << std::endl;
+        return false;
     }
-    ifs.close();
-    std::cout << "Model loaded successfully. Epsilon: " << epsilon << std::endl;
-}
\ No newline at end of file
+    if (!restore(checkpoint)) return false;
+
+    if (!quiet) std::cout << "Model loaded successfully. Epsilon: " << epsilon << std::endl;
+    return true;
+}
@@ -2,8 +2,13 @@
 #include <SFML/System.hpp>
 #include <deque>
 #include <vector>
+#include <random>
 #include "Node.h" 
 #include "SimpleNN.h"
+#include "TrainingConfig.h"
+#include "Checkpoint.h"
+
+struct WindowObservation;
 
 struct Experience {
     std::vector<double> state;
@@ -15,26 +20,45 @@ struct Experience {
 
 class AiAgent {
 public:
-    AiAgent();
+    explicit AiAgent(const TrainingConfig& config = TrainingConfig(), unsigned int seed = std::random_device{}());
     
     // Core Functions
-    int getAction(const std::vector<double>& state);
-    void train(const std::vector<Experience>& batch);
+    int getAction(const std::vector<double>& state); // window features go through the bit-packed first layer
+    int getAction(const WindowObservation& window); // window features without expanding the bits
+    std::vector<double> qValues(const std::vector<double>& state); // greedy network outputs, same routing as getAction
+    std::vector<int> getActions(const std::vector<double>& states, int count); // count states back to back, one forward pass (window features: one bit-packed pass each)
+    double train(const std::vector<Experience>& batch); // returns the mean squared TD error
     void decayEpsilon();
     
     // Helpers
-    std::vector<double> getState(const std::vector<std::vector<Node>>& grid, const sf::Vector2i& head, const sf::Vector2i& tail, const sf::Vector2i& food, const sf::Vector2i& direction);
+    static std::vector<double> getState(const std::vector<std::vector<Node>>& grid, const sf::Vector2i& head, const sf::Vector2i& tail, const sf::Vector2i& food, const sf::Vector2i& direction);
+    static std::vector<double> getState(FeatureSet features, const std::vector<std::vector<Node>>& grid, const sf::Vector2i& head, const sf::Vector2i& tail, const sf::Vector2i& food, const sf::Vector2i& direction, int length);
+    static int stateSize(FeatureSet features);
+    static int toAction(sf::Vector2i moveDir, sf::Vector2i direction);
+    static sf::Vector2i toDirection(int action, sf::Vector2i direction);
     
     // IO
     void save(const std::string& filename);
-    void load(const std::string& filename);
+    bool load(const std::string& filename, bool quiet = false); // quiet: only report errors
+    void snapshot(Checkpoint& out) const;
+    bool restore(const Checkpoint& checkpoint);
 
     NeuralNetwork brain;
+    TrainingConfig config;
     double epsilon = 0.5; // Exploration rate
-    double gamma = 0.9;   // Discount factor
+    std::mt19937 rng;     // Exploration and weight initialisation
+
+    static const int STATE_SIZE = 34;  // 24 (rays) + 2 (food) + 2 (tail) + 3 (danger) + 3 (flood fill)
+    static const int ACTION_COUNT = 3; // Straight, Left, Right
     
 private:
-    int inputSize = 34; // 24 (rays) + 2 (food) + 2 (tail) + 3 (danger) + 3 (flood fill)
-    int hiddenSize = 128;
-    int outputSize = 3; // Straight, Left, Right
+    void buildBrain(const std::vector<LayerSpec>& topology);
+    double trainSliced(const std::vector<Experience>& batch);
+
+    struct TrainSlice {
+        NeuralNetwork::Workspace workspace;
+        NeuralNetwork::Gradient gradient;
+        double squaredError = 0.0;
+    };
+    std::vector<TrainSlice> slices_;
 };
\ No newline at end of file
@@ -0,0 +1,32 @@
+#pragma once
+#include <vector>
+#include <SFML/System.hpp>
+#include "Node.h"
+#include "SnakeGame.h"
+
+// Immutable copy of what a viewer needs to draw one board. Capturing into an
+// existing snapshot reuses its storage.
+struct BoardSnapshot {
+    int rows = 0;
+    int cols = 0;
+    std::vector<NodeType> cells; // row-major
+    sf::Vector2i head = {0, 0};
+    sf::Vector2i direction = {1, 0};
+    int score = 0;
+    int highScore = 0;
+    int attempt = 0;
+    long long steps = 0;
+
+    void capture(const SnakeGame& game, sf::Vector2i dir) {
+        const auto& grid = game.getGrid();
+        rows = (int)grid.size();
+        cols = rows > 0 ? (int)grid[0].size() : 0;
+        cells.resize(rows * cols);
+        for (int r = 0; r < rows; ++r) {
+            for (int c = 0; c < cols; ++c) cells[r * cols + c] = grid[r][c].type;
+        }
+        head = game.getSnakeBody().front();
+        direction = dir;
+        score = game.getScore();
+    }
+};
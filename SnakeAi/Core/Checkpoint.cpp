@@ -0,0 +1,196 @@
+#include "Checkpoint.h"
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <sstream>
+#include <system_error>
+
+#ifdef _WIN32
+#include <cstdlib>
+#include <fcntl.h>
+#include <io.h>
+#include <process.h>
+#else
+#include <fcntl.h>
+#include <limits.h>
+#include <unistd.h>
+#endif
+
+size_t checkpointParamCount(const std::vector<LayerSpec>& topology) {
+    size_t count = 0;
+    for (size_t i = 1; i < topology.size(); ++i) {
+        count += (size_t)topology[i].size * (1 + topology[i - 1].size);
+    }
+    return count;
+}
+
+void formatCheckpoint(const Checkpoint& checkpoint, std::string& out) {
+    std::ostringstream header;
+    header << "VER3\n" << checkpoint.epsilon << "\n";
+    checkpoint.config.writeModel(header);
+    header << "weights\n";
+
+    out = header.str();
+    out.reserve(out.size() + checkpoint.params.size() * 24 + 16);
+
+    // Shortest round-trip formatting, much faster than ostream and lossless
+    char buf[32];
+    auto append = [&](double v) {
+        auto res = std::to_chars(buf, buf + sizeof(buf), v);
+        out.append(buf, res.ptr);
+        out.push_back(' ');
+    };
+
+    const auto& layers = checkpoint.config.layers;
+    size_t p = 0;
+    for (size_t i = 1; i < layers.size(); ++i) {
+        const int size = layers[i].size;
+        const int prevSize = layers[i - 1].size;
+        for (int j = 0; j < size; ++j) append(checkpoint.params[p++]);
+        out.push_back('\n');
+        for (int j = 0; j < size; ++j) {
+            for (int k = 0; k < prevSize; ++k) append(checkpoint.params[p++]);
+            out.push_back('\n');
+        }
+    }
+    out += "end\n";
+}
+
+CheckpointStatus parseCheckpoint(std::istream& is, Checkpoint& out) {
+    std::string header;
+    is >> header;
+
+    bool expectTrailer = true;
+    if (header == "VER3") {
+        if (!(is >> out.epsilon)) return CheckpointStatus::Corrupt;
+
+        // Settings block up to the "weights" marker
+        out.config = TrainingConfig();
+        std::string line;
+        bool sawWeights = false;
+        while (std::getline(is, line)) {
+            if (line == "weights") { sawWeights = true; break; }
+            out.config.setFromLine(line);
+        }
+        if (!sawWeights) return CheckpointStatus::Corrupt;
+    } else if (header == "VER2") {
+        // Legacy checkpoints only store weights for the original 34-128-3 network
+        if (!(is >> out.epsilon)) return CheckpointStatus::Corrupt;
+        out.config = TrainingConfig();
+        out.config.layers = {{34, Activation::Linear}, {128, Activation::Tanh}, {3, Activation::Tanh}};
+        expectTrailer = false;
+    } else {
+        return CheckpointStatus::UnknownFormat;
+    }
+
+    out.params.resize(checkpointParamCount(out.config.layers));
+    for (double& v : out.params) {
+        if (!(is >> v)) return CheckpointStatus::Corrupt;
+    }
+    if (expectTrailer) {
+        std::string trailer;
+        if (!(is >> trailer) || trailer != "end") return CheckpointStatus::Corrupt;
+    }
+    return CheckpointStatus::Ok;
+}
+
+namespace {
+    bool writeAll(const std::string& path, const std::string& data, bool durable) {
+#ifdef _WIN32
+        int fd = _open(path.c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, 0644);
+        if (fd < 0) return false;
+        size_t written = 0;
+        while (written < data.size()) {
+            int n = _write(fd, data.data() + written, (unsigned int)std::min<size_t>(data.size() - written, 1 << 30));
+            if (n <= 0) { _close(fd); return false; }
+            written += (size_t)n;
+        }
+        bool ok = !durable || _commit(fd) == 0;
+        return _close(fd) == 0 && ok;
+#else
+        int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) return false;
+        size_t written = 0;
+        while (written < data.size()) {
+            ssize_t n = ::write(fd, data.data() + written, data.size() - written);
+            if (n <= 0) { ::close(fd); return false; }
+            written += (size_t)n;
+        }
+        bool ok = !durable || ::fsync(fd) == 0;
+        return ::close(fd) == 0 && ok;
+#endif
+    }
+
+    void syncDirectory(const std::string& path) {
+#ifndef _WIN32
+        // Make the rename itself durable
+        std::string dir = std::filesystem::path(path).parent_path().string();
+        int fd = ::open(dir.empty() ? "." : dir.c_str(), O_RDONLY);
+        if (fd >= 0) {
+            ::fsync(fd);
+            ::close(fd);
+        }
+#endif
+    }
+}
+
+FileStamp fileStamp(const std::string& path) {
+    std::error_code ec;
+    const auto modified = std::filesystem::last_write_time(path, ec);
+    if (ec) return {};
+    const auto size = std::filesystem::file_size(path, ec);
+    if (ec) return {};
+    return {(long long)modified.time_since_epoch().count(), (long long)size};
+}
+
+std::string writerTag() {
+    std::string host;
+#ifdef _WIN32
+    if (const char* name = std::getenv("COMPUTERNAME")) host = name;
+#else
+    char name[HOST_NAME_MAX + 1] = {};
+    if (::gethostname(name, sizeof(name) - 1) == 0) host = name;
+#endif
+    std::string tag;
+    for (char c : host) {
+        const bool plain = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '-' || c == '_';
+        tag.push_back(plain ? c : '_');
+    }
+    return tag.empty() ? "local" : tag;
+}
+
+bool writeFileAtomically(const std::string& path, const std::string& data, bool durable, const std::string& historyPath) {
+    // Pods sharing a volume write the same path; each one truncates only its own temp file
+#ifdef _WIN32
+    const long long pid = _getpid();
+#else
+    const long long pid = ::getpid();
+#endif
+    const std::string tempFilename = path + ".tmp." + writerTag() + "." + std::to_string(pid);
+    if (!writeAll(tempFilename, data, durable)) {
+        std::cerr << "Error: Could not write " << path << " (via " << tempFilename << ")" << std::endl;
+        return false;
+    }
+
+    if (!historyPath.empty()) {
+        // A hard link costs no extra I/O; fall back to a copy where unsupported.
+        // Both fail rather than replace a file that already exists.
+        std::error_code ec;
+        std::filesystem::create_hard_link(tempFilename, historyPath, ec);
+        if (ec && ec != std::errc::file_exists) std::filesystem::copy_file(tempFilename, historyPath, std::filesystem::copy_options::none, ec);
+        if (ec) std::cerr << "Error: Could not keep checkpoint " << historyPath << ": " << ec.message() << std::endl;
+    }
+
+    // Atomic swap: This prevents other pods from reading a half-written file
+    std::error_code ec;
+    std::filesystem::rename(tempFilename, path, ec);
+    if (ec) {
+        std::cerr << "Error: Atomic rename failed for " << path << std::endl;
+        std::filesystem::remove(tempFilename, ec);
+        return false;
+    }
+    if (durable) syncDirectory(path);
+    return true;
+}
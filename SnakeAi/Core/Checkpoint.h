@@ -0,0 +1,44 @@
+#pragma once
+#include <istream>
+#include <string>
+#include <vector>
+#include "TrainingConfig.h"
+
+/**
+ * @brief Flat copy of everything a model file stores. Parameters are kept in
+ * file order: for every layer after the input, its biases and then its weight
+ * rows. Reusing one instance avoids reallocating on every snapshot.
+ */
+struct Checkpoint {
+    double epsilon = 0.0;
+    TrainingConfig config;
+    std::vector<double> params;
+};
+
+enum class CheckpointStatus { Ok, UnknownFormat, Corrupt };
+
+// Number of parameters a network with this topology stores.
+size_t checkpointParamCount(const std::vector<LayerSpec>& topology);
+
+// VER3 text: header, model settings, "weights", one line of biases and one line per
+// weight row for every layer, then an "end" marker so truncation is detected.
+void formatCheckpoint(const Checkpoint& checkpoint, std::string& out);
+CheckpointStatus parseCheckpoint(std::istream& is, Checkpoint& out);
+
+// Writes to a temporary file private to this process, optionally fsyncs it,
+// then renames it over <path>. If historyPath is set, the finished file is also
+// linked (or copied) there; an existing historyPath is never replaced.
+bool writeFileAtomically(const std::string& path, const std::string& data, bool durable, const std::string& historyPath = "");
+
+// Modification time and size of a file, enough to notice that a writer replaced it.
+// A missing file has the default stamp.
+struct FileStamp {
+    long long modified = -1;
+    long long size = -1;
+    bool operator==(const FileStamp&) const = default;
+};
+FileStamp fileStamp(const std::string& path);
+
+// This machine's host name reduced to [A-Za-z0-9_-], e.g. the pod name. Tags the
+// files a writer owns next to a model file shared by several workers.
+std::string writerTag();
@@ -0,0 +1,60 @@
+#include "CheckpointWatcher.h"
+#include <chrono>
+#include <fstream>
+#include <iostream>
+
+CheckpointWatcher::CheckpointWatcher(std::string path, double pollSeconds)
+    : path_(std::move(path)), pollSeconds_(pollSeconds), seen_(fileStamp(path_))
+{
+    worker_ = std::thread(&CheckpointWatcher::watchLoop, this);
+}
+
+CheckpointWatcher::~CheckpointWatcher() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    cv_.notify_all();
+    if (worker_.joinable()) worker_.join();
+}
+
+bool CheckpointWatcher::take(Checkpoint& out, const FileStamp& ignore) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!hasReady_) return false;
+    hasReady_ = false;
+    if (readyStamp_ == ignore) return false;
+    std::swap(out, ready_);
+    return true;
+}
+
+void CheckpointWatcher::discard() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    hasReady_ = false;
+    generation_++;
+}
+
+void CheckpointWatcher::watchLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!cv_.wait_for(lock, std::chrono::duration<double>(pollSeconds_), [&] { return stop_; })) {
+        const long long generation = generation_;
+        lock.unlock();
+
+        bool parsed = false;
+        const FileStamp stamp = fileStamp(path_);
+        if (stamp != seen_ && stamp != FileStamp()) {
+            seen_ = stamp;
+            std::ifstream ifs(path_);
+            const CheckpointStatus status = ifs.is_open() ? parseCheckpoint(ifs, parsed_) : CheckpointStatus::Corrupt;
+            // Files are replaced by atomic renames, so this only reports each damaged version once
+            if (status == CheckpointStatus::Ok) parsed = true;
+            else std::cerr << "Error: Model " << path_ << " is incomplete or corrupt." << std::endl;
+        }
+
+        lock.lock();
+        if (parsed && generation == generation_) {
+            std::swap(ready_, parsed_);
+            readyStamp_ = stamp;
+            hasReady_ = true;
+        }
+    }
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "Checkpoint.h"
+
+/**
+ * @brief Reads a model file shared with other workers on a background thread,
+ * so training never waits on storage to pick up their weights. The thread
+ * checks the file's FileStamp every pollSeconds and parses it only when it
+ * changed; the trainer takes the parsed Checkpoint at an attempt boundary and
+ * restores it with AiAgent::restore().
+ *
+ * The file as it is at construction counts as already seen: the trainer loads
+ * it at startup itself.
+ */
+class CheckpointWatcher {
+public:
+    explicit CheckpointWatcher(std::string path, double pollSeconds = 1.0);
+    ~CheckpointWatcher();
+
+    // Moves the newest unread checkpoint into `out`. A checkpoint whose stamp
+    // equals `ignore` (e.g. our own last write) is dropped instead.
+    bool take(Checkpoint& out, const FileStamp& ignore = {});
+    // Drops anything read so far, including a parse in progress; call it when
+    // submitting weights newer than whatever the file held until now.
+    void discard();
+
+private:
+    void watchLoop();
+
+    std::string path_;
+    double pollSeconds_;
+    FileStamp seen_;          // watcher thread only
+    Checkpoint parsed_;       // watcher thread only
+    Checkpoint ready_;        // guarded by mutex_
+    FileStamp readyStamp_;
+    bool hasReady_ = false;
+    long long generation_ = 0; // bumped by discard()
+    bool stop_ = false;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::thread worker_;
+};
@@ -0,0 +1,130 @@
+#include "CheckpointWriter.h"
+#include "AiAgent.h"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <vector>
+
+namespace {
+    struct HistoryFile {
+        long long sequence;
+        std::string owner; // writerTag() of the writer, empty for files from before owners were recorded
+        std::string file;
+    };
+
+    // Existing <path>.<digits>[.<owner>] files, newest first
+    std::vector<HistoryFile> listHistory(const std::string& path) {
+        std::vector<HistoryFile> found;
+        const std::filesystem::path base(path);
+        const std::filesystem::path dir = base.parent_path().empty() ? std::filesystem::path(".") : base.parent_path();
+        const std::string prefix = base.filename().string() + ".";
+
+        std::error_code ec;
+        for (const auto& entry : std::filesystem::directory_iterator(dir, ec)) {
+            const std::string name = entry.path().filename().string();
+            if (name.size() <= prefix.size() || name.compare(0, prefix.size(), prefix) != 0) continue;
+            const std::string suffix = name.substr(prefix.size());
+            const size_t dot = suffix.find('.');
+            const std::string digits = suffix.substr(0, dot);
+            if (digits.empty() || digits.size() > 18) continue;
+            if (!std::all_of(digits.begin(), digits.end(), [](char c) { return c >= '0' && c <= '9'; })) continue;
+            const std::string owner = dot == std::string::npos ? "" : suffix.substr(dot + 1);
+            if (dot != std::string::npos && (owner.empty() || owner.find('.') != std::string::npos)) continue;
+            found.push_back({std::stoll(digits), owner, entry.path().string()});
+        }
+        std::sort(found.begin(), found.end(), [](const auto& a, const auto& b) { return a.sequence > b.sequence; });
+        return found;
+    }
+}
+
+CheckpointWriter::CheckpointWriter(std::string path, int keepLast)
+    : path_(std::move(path)), owner_(writerTag()), keepLast_(std::max(0, keepLast))
+{
+    worker_ = std::thread(&CheckpointWriter::writerLoop, this);
+}
+
+CheckpointWriter::~CheckpointWriter() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    cv_.notify_all();
+    if (worker_.joinable()) worker_.join();
+}
+
+void CheckpointWriter::submit(const AiAgent& agent) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        agent.snapshot(pending_);
+        hasPending_ = true;
+    }
+    cv_.notify_all();
+}
+
+void CheckpointWriter::flush() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [&] { return !hasPending_ && !busy_; });
+}
+
+FileStamp CheckpointWriter::lastWritten() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return lastWritten_;
+}
+
+bool CheckpointWriter::idle() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return !hasPending_ && !busy_;
+}
+
+void CheckpointWriter::writerLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        cv_.wait(lock, [&] { return hasPending_ || stop_; });
+        if (!hasPending_) break; // stopping with nothing left to write
+
+        std::swap(pending_, writing_);
+        hasPending_ = false;
+        busy_ = true;
+        lock.unlock();
+
+        auto start = std::chrono::steady_clock::now();
+        formatCheckpoint(writing_, text_);
+        std::string history;
+        if (keepLast_ > 0) {
+            // Numbered after the newest snapshot of any writer, so loadLatest() tries them in write order
+            const auto existing = listHistory(path_);
+            sequence_ = std::max(sequence_, existing.empty() ? 0 : existing.front().sequence) + 1;
+            history = path_ + "." + std::to_string(sequence_) + "." + owner_;
+        }
+        const bool written = writeFileAtomically(path_, text_, true, history);
+        if (written && keepLast_ > 0) prune();
+        const FileStamp stamp = written ? fileStamp(path_) : FileStamp();
+        lastWriteSeconds_ = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        writes_++;
+
+        lock.lock();
+        if (written) lastWritten_ = stamp;
+        busy_ = false;
+        cv_.notify_all();
+    }
+}
+
+// Only this writer's snapshots; the other workers keep their own
+void CheckpointWriter::prune() {
+    int kept = 0;
+    for (const HistoryFile& h : listHistory(path_)) {
+        if (h.owner != owner_ || ++kept <= keepLast_) continue;
+        std::error_code ec;
+        std::filesystem::remove(h.file, ec);
+    }
+}
+
+bool CheckpointWriter::loadLatest(AiAgent& agent, const std::string& path) {
+    if (agent.load(path)) return true;
+    for (const HistoryFile& h : listHistory(path)) {
+        std::cout << "Trying previous checkpoint " << h.file << std::endl;
+        if (agent.load(h.file)) return true;
+    }
+    return false;
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "Checkpoint.h"
+
+class AiAgent;
+
+/**
+ * @brief Saves checkpoints on a background thread so training never waits on
+ * storage. submit() only copies the weights into a pending buffer; the writer
+ * thread swaps it out, formats it, fsyncs and atomically renames it over the
+ * model file. If a newer snapshot arrives before the previous one was taken,
+ * it simply replaces it.
+ *
+ * With keepLast > 0 every written checkpoint is also kept as
+ * <path>.<sequence>.<writerTag()> and only the newest keepLast of this writer's
+ * files are retained. Several pods can share one model file: each writes its
+ * own temporary file and never replaces or prunes another pod's snapshots.
+ */
+class CheckpointWriter {
+public:
+    CheckpointWriter(std::string path, int keepLast = 3);
+    ~CheckpointWriter(); // writes any pending snapshot before returning
+
+    void submit(const AiAgent& agent);
+    void flush();       // blocks until everything submitted so far is on disk
+    bool idle() const;  // nothing pending or being written
+    FileStamp lastWritten() const; // the model file as our last write left it
+
+    double lastWriteSeconds() const { return lastWriteSeconds_.load(); }
+    long long writes() const { return writes_.load(); } // completed write attempts
+
+    // Loads <path>, falling back to the newest valid snapshot of any writer.
+    static bool loadLatest(AiAgent& agent, const std::string& path);
+
+private:
+    void writerLoop();
+    void prune();
+
+    std::string path_;
+    std::string owner_;
+    int keepLast_;
+    long long sequence_ = 0;
+
+    Checkpoint pending_;  // filled by submit()
+    Checkpoint writing_;  // owned by the writer thread while busy_
+    std::string text_;
+    bool hasPending_ = false;
+    bool busy_ = false;
+    bool stop_ = false;
+    FileStamp lastWritten_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::atomic<double> lastWriteSeconds_{0.0};
+    std::atomic<long long> writes_{0};
+    std::thread worker_;
+};
@@ -0,0 +1,153 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <SFML/System.hpp>
+#include "SnakeGame.h"
+
+/**
+ * @brief Flat, trivially-copyable copy of a SnakeGame position for simulation
+ * (rollouts, search), with no heap. The struct has room for a 128x128 board
+ * (~6 KB); cloneInto() copies only the part the board uses (~240 bytes at 25x25).
+ *
+ * The body is stored as an occupancy bitset plus a 2-bit link per cell pointing
+ * towards the next segment nearer the head. Moving the tail therefore only
+ * follows one link; no list of segments is kept. Food is respawned from an
+ * embedded splitmix64 generator, so every clone can be reseeded independently.
+ * Movement rules match SnakeGame::step exactly.
+ */
+struct CompactGame {
+    static constexpr int MAX_SIDE = 128;
+    static constexpr int MAX_CELLS = MAX_SIDE * MAX_SIDE;
+    static constexpr uint16_t NO_FOOD = 0xFFFF;
+
+    enum StepResult : uint8_t { Died, Moved, Ate };
+
+    int16_t rows;
+    int16_t cols;
+    uint16_t head;
+    uint16_t tail;
+    uint16_t food;
+    uint16_t length;
+    sf::Vector2i direction;
+    uint64_t rng;
+    uint64_t occupied[MAX_CELLS / 64];
+    uint8_t links[MAX_CELLS / 4]; // 2 bits per cell, see DX/DY
+
+    static bool fits(const SnakeGame& game) {
+        const auto& grid = game.getGrid();
+        return !grid.empty() && (int)grid.size() <= MAX_SIDE && (int)grid[0].size() <= MAX_SIDE;
+    }
+
+    static CompactGame from(const SnakeGame& game, uint64_t seed = 0) {
+        CompactGame g{};
+        const auto& grid = game.getGrid();
+        const auto& body = game.getSnakeBody();
+        g.rows = (int16_t)grid.size();
+        g.cols = (int16_t)grid[0].size();
+        g.head = g.cell(body.front());
+        g.tail = g.cell(body.back());
+        g.length = (uint16_t)body.size();
+        g.food = game.getFoodPos().x < 0 ? NO_FOOD : g.cell(game.getFoodPos());
+        g.direction = game.getDirection();
+        g.rng = seed;
+        for (size_t i = 0; i < body.size(); ++i) {
+            g.setOccupied(g.cell(body[i]), true);
+            if (i > 0) g.setLink(g.cell(body[i]), dirIndex(body[i - 1] - body[i]));
+        }
+        return g;
+    }
+
+    void reseed(uint64_t seed) { rng = seed; }
+
+    // Copies this position into out; bitset words and links past the board are left as they were
+    void cloneInto(CompactGame& out) const {
+        const int cells = rows * cols;
+        out.rows = rows;
+        out.cols = cols;
+        out.head = head;
+        out.tail = tail;
+        out.food = food;
+        out.length = length;
+        out.direction = direction;
+        out.rng = rng;
+        std::memcpy(out.occupied, occupied, (size_t)(cells + 63) / 64 * sizeof(uint64_t));
+        std::memcpy(out.links, links, (size_t)(cells + 3) / 4);
+    }
+
+    uint16_t cell(sf::Vector2i p) const { return (uint16_t)(p.y * cols + p.x); }
+    sf::Vector2i pos(uint16_t c) const { return {c % cols, c / cols}; }
+    bool inside(sf::Vector2i p) const { return p.x >= 0 && p.x < cols && p.y >= 0 && p.y < rows; }
+    bool isSnake(uint16_t c) const { return (occupied[c >> 6] >> (c & 63)) & 1; }
+    sf::Vector2i headPos() const { return pos(head); }
+    sf::Vector2i foodPos() const { return food == NO_FOOD ? sf::Vector2i(-1, -1) : pos(food); }
+
+    // Whether moving the head by d is immediately fatal
+    bool isFatal(sf::Vector2i d) const {
+        const sf::Vector2i next = headPos() + d;
+        if (!inside(next)) return true;
+        const uint16_t c = cell(next);
+        return isSnake(c) && c != tail;
+    }
+
+    StepResult step(sf::Vector2i d) {
+        if (isFatal(d)) return Died;
+        const uint16_t next = cell(headPos() + d);
+        setLink(head, dirIndex(d));
+        direction = d;
+
+        if (next == food) {
+            head = next;
+            setOccupied(next, true);
+            length++;
+            spawnFood();
+            return Ate;
+        }
+        const uint16_t oldTail = tail;
+        tail = (uint16_t)(tail + DX[link(tail)] + DY[link(tail)] * cols);
+        setOccupied(oldTail, false);
+        setOccupied(next, true);
+        head = next;
+        return Moved;
+    }
+
+private:
+    // Link directions: up, down, left, right
+    static constexpr int DX[4] = {0, 0, -1, 1};
+    static constexpr int DY[4] = {-1, 1, 0, 0};
+
+    static uint8_t dirIndex(sf::Vector2i d) { return d.y < 0 ? 0 : d.y > 0 ? 1 : d.x < 0 ? 2 : 3; }
+
+    uint8_t link(uint16_t c) const { return (links[c >> 2] >> ((c & 3) * 2)) & 3; }
+    void setLink(uint16_t c, uint8_t dir) {
+        uint8_t& byte = links[c >> 2];
+        byte = (uint8_t)((byte & ~(3 << ((c & 3) * 2))) | (dir << ((c & 3) * 2)));
+    }
+    void setOccupied(uint16_t c, bool value) {
+        if (value) occupied[c >> 6] |= (1ull << (c & 63));
+        else occupied[c >> 6] &= ~(1ull << (c & 63));
+    }
+
+    uint64_t nextRandom() {
+        uint64_t z = (rng += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    void spawnFood() {
+        const int cells = rows * cols;
+        if (length >= cells) { food = NO_FOOD; return; }
+        // Rejection sampling is cheap until the board is nearly full
+        for (int tries = 0; tries < 32; ++tries) {
+            const uint16_t c = (uint16_t)(nextRandom() % cells);
+            if (!isSnake(c)) { food = c; return; }
+        }
+        int pick = (int)(nextRandom() % (cells - length));
+        for (uint16_t c = 0; c < cells; ++c) {
+            if (!isSnake(c) && pick-- == 0) { food = c; return; }
+        }
+    }
+};
+
+static_assert(std::is_trivially_copyable_v<CompactGame>, "CompactGame must stay memcpy-able");
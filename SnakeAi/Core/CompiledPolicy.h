@@ -0,0 +1,257 @@
+#pragma once
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "AiAgent.h"
+#include "SimpleNN.h"
+#include "TrainingConfig.h"
+#include "WindowFeatures.h"
+
+/**
+ * @brief Frozen In -> Hidden -> Out network for serving a trained policy.
+ *
+ * The shape is a template parameter, so every loop has a compile-time trip count
+ * and the weights live in fixed arrays inside the object. Weights are float,
+ * with the hidden layer stored input-major and padded to whole SIMD lanes. The
+ * hidden layer adds one weight column per non-zero input, which skips the many
+ * zero ray features and the unset window bits. act() runs the whole pass in one
+ * call with no allocations: hidden accumulation, bias, activation, output dot
+ * products and argmax.
+ *
+ * Float weights can change a decision only when two action values are within
+ * float rounding of each other. --bench-policy reports the agreement with the
+ * double network.
+ *
+ * File layout (native byte order):
+ *   "SNKP" | uint32 version | uint32 features | uint32 in | uint32 hidden | uint32 out |
+ *   uint32 hidden activation | uint32 output activation |
+ *   float hidden weights [in][hidden] | float hidden biases [hidden] |
+ *   float output weights [out][hidden] | float output biases [out]
+ */
+template <int In, int Hidden, int Out>
+class CompiledPolicy {
+public:
+    static_assert(In > 0 && Hidden > 0 && Out > 0, "CompiledPolicy needs non-empty layers");
+    static constexpr int INPUTS = In;
+    static constexpr int HIDDEN = Hidden;
+    static constexpr int OUTPUTS = Out;
+
+    // Packs a trained network; false (with a message) when its shape differs
+    bool compile(const NeuralNetwork& net, FeatureSet features) {
+        if (net.layers.size() != 3 || net.layers[0].size != In || net.layers[1].size != Hidden || net.layers[2].size != Out) {
+            std::cerr << "Error: Network shape does not match the compiled policy " << In << "," << Hidden << "," << Out << std::endl;
+            return false;
+        }
+        clear();
+        features_ = features;
+        hiddenActivation_ = net.layers[1].activation;
+        outputActivation_ = net.layers[2].activation;
+        for (int j = 0; j < Hidden; ++j) {
+            b1_[j] = (float)net.layers[1].biases[j];
+            for (int i = 0; i < In; ++i) w1_[i * PADDED + j] = (float)net.layers[1].weights[j][i];
+        }
+        for (int o = 0; o < Out; ++o) {
+            b2_[o] = (float)net.layers[2].biases[o];
+            for (int j = 0; j < Hidden; ++j) w2_[o * PADDED + j] = (float)net.layers[2].weights[o][j];
+        }
+        return true;
+    }
+
+    bool save(const std::string& filename) const {
+        std::ofstream ofs(filename, std::ios::binary | std::ios::trunc);
+        if (!ofs.is_open()) {
+            std::cerr << "Error: Could not write policy " << filename << std::endl;
+            return false;
+        }
+        const uint32_t header[7] = {VERSION, (uint32_t)features_, In, Hidden, Out, (uint32_t)hiddenActivation_, (uint32_t)outputActivation_};
+        ofs.write("SNKP", 4);
+        ofs.write(reinterpret_cast<const char*>(header), sizeof(header));
+        for (int i = 0; i < In; ++i) ofs.write(reinterpret_cast<const char*>(&w1_[i * PADDED]), Hidden * sizeof(float));
+        ofs.write(reinterpret_cast<const char*>(b1_), Hidden * sizeof(float));
+        for (int o = 0; o < Out; ++o) ofs.write(reinterpret_cast<const char*>(&w2_[o * PADDED]), Hidden * sizeof(float));
+        ofs.write(reinterpret_cast<const char*>(b2_), Out * sizeof(float));
+        ofs.flush();
+        if (!ofs) {
+            std::cerr << "Error: Could not write policy " << filename << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    // False (with a message) for a missing or damaged file or another shape
+    bool load(const std::string& filename) {
+        std::ifstream ifs(filename, std::ios::binary);
+        if (!ifs.is_open()) {
+            std::cerr << "Error: Could not open policy " << filename << std::endl;
+            return false;
+        }
+        char magic[4] = {};
+        uint32_t header[7] = {};
+        ifs.read(magic, 4);
+        ifs.read(reinterpret_cast<char*>(header), sizeof(header));
+        if (!ifs || std::memcmp(magic, "SNKP", 4) != 0 || header[0] != VERSION || header[1] > (uint32_t)FeatureSet::Window ||
+            header[5] > (uint32_t)Activation::FastTanh || header[6] > (uint32_t)Activation::FastTanh) {
+            std::cerr << "Error: " << filename << " is not a compiled policy." << std::endl;
+            return false;
+        }
+        if (header[2] != (uint32_t)In || header[3] != (uint32_t)Hidden || header[4] != (uint32_t)Out) {
+            std::cerr << "Error: Policy " << filename << " is " << header[2] << "," << header[3] << "," << header[4]
+                      << ", not " << In << "," << Hidden << "," << Out << std::endl;
+            return false;
+        }
+        clear();
+        features_ = (FeatureSet)header[1];
+        hiddenActivation_ = (Activation)header[5];
+        outputActivation_ = (Activation)header[6];
+        for (int i = 0; i < In; ++i) ifs.read(reinterpret_cast<char*>(&w1_[i * PADDED]), Hidden * sizeof(float));
+        ifs.read(reinterpret_cast<char*>(b1_), Hidden * sizeof(float));
+        for (int o = 0; o < Out; ++o) ifs.read(reinterpret_cast<char*>(&w2_[o * PADDED]), Hidden * sizeof(float));
+        ifs.read(reinterpret_cast<char*>(b2_), Out * sizeof(float));
+        if (!ifs || ifs.peek() != std::char_traits<char>::eof()) {
+            std::cerr << "Error: Policy " << filename << " is incomplete or corrupt." << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    FeatureSet features() const { return features_; }
+
+    // Greedy action for In dense inputs
+    int act(const double* input) const {
+        alignas(64) float hidden[PADDED];
+        std::memcpy(hidden, b1_, sizeof(hidden));
+        for (int i = 0; i < In; ++i) {
+            if (input[i] != 0.0) addColumn(hidden, i, (float)input[i]);
+        }
+        return finish(hidden);
+    }
+    int act(const std::vector<double>& input) const { return act(input.data()); }
+
+    // Greedy action for packed window features
+    int act(const WindowObservation& window) const requires (In == WindowObservation::INPUT_SIZE) {
+        alignas(64) float hidden[PADDED];
+        std::memcpy(hidden, b1_, sizeof(hidden));
+        for (int w = 0; w < (WindowObservation::BITS + 63) / 64; ++w) {
+            for (uint64_t word = window.bits[w]; word != 0; word &= word - 1) addColumn(hidden, w * 64 + std::countr_zero(word), 1.0f);
+        }
+        for (int k = 0; k < WindowObservation::EXTRAS; ++k) {
+            if (window.extras[k] != 0.0) addColumn(hidden, WindowObservation::BITS + k, (float)window.extras[k]);
+        }
+        return finish(hidden);
+    }
+
+private:
+    static constexpr uint32_t VERSION = 1;
+    static constexpr int LANES = 8;
+    static constexpr int PADDED = (Hidden + LANES - 1) / LANES * LANES; // padding weights and biases stay 0
+
+    void clear() {
+        std::memset(w1_, 0, sizeof(w1_));
+        std::memset(b1_, 0, sizeof(b1_));
+        std::memset(w2_, 0, sizeof(w2_));
+        std::memset(b2_, 0, sizeof(b2_));
+    }
+
+    void addColumn(float* hidden, int input, float x) const {
+        const float* w = &w1_[input * PADDED];
+        for (int j = 0; j < PADDED; ++j) hidden[j] += x * w[j];
+    }
+
+    // The activation is resolved once per call, outside the inner loops
+    int finish(float* hidden) const {
+        switch (hiddenActivation_) {
+            case Activation::Linear:   return output<Activation::Linear>(hidden);
+            case Activation::ReLU:     return output<Activation::ReLU>(hidden);
+            case Activation::FastTanh: return output<Activation::FastTanh>(hidden);
+            default:                   return output<Activation::Tanh>(hidden);
+        }
+    }
+
+    // Rational minimax tanh (degree 13/6) clamped where float tanh reaches 1, within
+    // 4e-7 of std::tanh. Unlike the libm call it has no branches, so the hidden
+    // layer's activation loop vectorizes.
+    static float tanhFloat(float x) {
+        const float clamp = 7.90531110763549805f;
+        x = x > clamp ? clamp : (x < -clamp ? -clamp : x);
+        const float x2 = x * x;
+        float p = -2.76076847742355e-16f;
+        p = p * x2 + 2.00018790482477e-13f;
+        p = p * x2 - 8.60467152213735e-11f;
+        p = p * x2 + 5.12229709037114e-08f;
+        p = p * x2 + 1.48572235717979e-05f;
+        p = p * x2 + 6.37261928875436e-04f;
+        p = p * x2 + 4.89352455891786e-03f;
+        float q = 1.19825839466702e-06f;
+        q = q * x2 + 1.18534705686654e-04f;
+        q = q * x2 + 2.26843463243900e-03f;
+        q = q * x2 + 4.89352518554385e-03f;
+        return x * p / q;
+    }
+
+    template <Activation A>
+    static float apply(float x) {
+        if constexpr (A == Activation::ReLU) return x > 0.0f ? x : 0.0f;
+        else if constexpr (A == Activation::Tanh) return tanhFloat(x);
+        else if constexpr (A == Activation::FastTanh) return (float)fastTanh(x);
+        else return x;
+    }
+
+    template <Activation A>
+    int output(float* hidden) const {
+        for (int j = 0; j < PADDED; ++j) hidden[j] = apply<A>(hidden[j]);
+
+        int best = 0;
+        float bestValue = 0.0f;
+        for (int o = 0; o < Out; ++o) {
+            // LANES partial sums, so the dot product vectorizes without reassociation
+            const float* w = &w2_[o * PADDED];
+            float partial[LANES] = {};
+            for (int j = 0; j < PADDED; j += LANES) {
+                for (int l = 0; l < LANES; ++l) partial[l] += w[j + l] * hidden[j + l];
+            }
+            float value = b2_[o];
+            for (int l = 0; l < LANES; ++l) value += partial[l];
+            // tanh is strictly increasing, so the argmax can use the raw value. Applying
+            // it in float would saturate to 1 far sooner than the double network does.
+            if (outputActivation_ == Activation::ReLU) value = apply<Activation::ReLU>(value);
+            else if (outputActivation_ == Activation::FastTanh) value = apply<Activation::FastTanh>(value); // clamps, like the network
+            if (o == 0 || value > bestValue) { best = o; bestValue = value; } // first maximum, like std::max_element
+        }
+        return best;
+    }
+
+    alignas(64) float w1_[In * PADDED] = {}; // input i's column at i * PADDED
+    alignas(64) float b1_[PADDED] = {};
+    alignas(64) float w2_[Out * PADDED] = {}; // output o's row at o * PADDED
+    float b2_[Out] = {};
+    Activation hiddenActivation_ = Activation::Linear;
+    Activation outputActivation_ = Activation::Linear;
+    FeatureSet features_ = FeatureSet::Rays;
+};
+
+/**
+ * @brief Calls f(policy) with a new CompiledPolicy of the given topology, or
+ * returns false when no instantiation has that shape. To serve another
+ * topology, add its shape here.
+ */
+template <typename F>
+bool withCompiledPolicy(const std::vector<LayerSpec>& layers, F&& f) {
+    constexpr int RAYS = AiAgent::STATE_SIZE;
+    constexpr int WINDOW = WindowObservation::INPUT_SIZE;
+    constexpr int ACTIONS = AiAgent::ACTION_COUNT;
+    if (layers.size() != 3 || layers[2].size != ACTIONS) return false;
+    auto run = [&](auto policy) { f(*policy); return true; };
+    const int in = layers[0].size, hidden = layers[1].size;
+    if (in == RAYS && hidden == 64)    return run(std::make_unique<CompiledPolicy<RAYS, 64, ACTIONS>>());
+    if (in == RAYS && hidden == 128)   return run(std::make_unique<CompiledPolicy<RAYS, 128, ACTIONS>>());
+    if (in == RAYS && hidden == 256)   return run(std::make_unique<CompiledPolicy<RAYS, 256, ACTIONS>>());
+    if (in == WINDOW && hidden == 128) return run(std::make_unique<CompiledPolicy<WINDOW, 128, ACTIONS>>());
+    if (in == WINDOW && hidden == 256) return run(std::make_unique<CompiledPolicy<WINDOW, 256, ACTIONS>>());
+    return false;
+}
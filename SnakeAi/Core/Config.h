@@ -16,12 +16,13 @@ namespace Config {
     inline const int GRID_COLS = 25;
     inline const float OUTLINE_THICKNESS = 1.0f;
     inline const float CELL_PADDING = 1.0f;
+    inline const int TILED_BOARDS = 16; // Boards in the tiled population view (--tiles overrides)
 
-    // AI Training Settings
+    // AI Training Settings (defaults for TrainingConfig, overridable from a config file)
     inline const sf::Time MOVE_INTERVAL = sf::milliseconds(100);
     inline const int REPLAY_MEMORY_SIZE = 10000;
     inline const int BATCH_SIZE = 32;
-    inline const double GAMMA = 0.99; // Value future rewards more
+    inline const double GAMMA = 0.9; // Discount factor (the value AiAgent has always trained with)
     inline const double EPSILON_DECAY = 0.997; // Faster decay (hits 0.01 in ~1500 games)
     inline const double MIN_EPSILON = 0.00001;
 
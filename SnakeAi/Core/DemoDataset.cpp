@@ -0,0 +1,201 @@
+#include "DemoDataset.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+namespace {
+    const char SHARD_MAGIC[4] = {'S', 'N', 'K', 'D'};
+    const uint32_t SHARD_VERSION = 1;
+    const long long HEADER_BYTES = 16;
+    const size_t WRITE_BUFFER_BYTES = 1 << 16;
+
+    size_t recordBytes(int featureCount) { return featureCount * sizeof(float) + 1; }
+}
+
+bool DemoShardWriter::open(const std::string& path, int featureCount) {
+    close();
+    ofs_.open(path, std::ios::binary | std::ios::trunc);
+    if (!ofs_.is_open()) {
+        std::cerr << "Error: Could not open demo shard " << path << std::endl;
+        return false;
+    }
+    featureCount_ = featureCount;
+    count_ = 0;
+
+    uint32_t header[3] = {SHARD_VERSION, (uint32_t)featureCount, 0};
+    ofs_.write(SHARD_MAGIC, sizeof(SHARD_MAGIC));
+    ofs_.write(reinterpret_cast<const char*>(header), sizeof(header));
+    buffer_.clear();
+    buffer_.reserve(WRITE_BUFFER_BYTES + recordBytes(featureCount));
+    return true;
+}
+
+void DemoShardWriter::write(const std::vector<double>& features, int action) {
+    if (!ofs_.is_open() || (int)features.size() != featureCount_) return;
+
+    const size_t offset = buffer_.size();
+    buffer_.resize(offset + recordBytes(featureCount_));
+    char* out = buffer_.data() + offset;
+    for (int i = 0; i < featureCount_; ++i) {
+        float f = (float)features[i];
+        std::memcpy(out + i * sizeof(float), &f, sizeof(float));
+    }
+    out[featureCount_ * sizeof(float)] = (char)action;
+    count_++;
+
+    if (buffer_.size() >= WRITE_BUFFER_BYTES) {
+        ofs_.write(buffer_.data(), (std::streamsize)buffer_.size());
+        buffer_.clear();
+    }
+}
+
+void DemoShardWriter::close() {
+    if (!ofs_.is_open()) return;
+    ofs_.write(buffer_.data(), (std::streamsize)buffer_.size());
+    buffer_.clear();
+    ofs_.close();
+}
+
+DemoDatasetReader::DemoDatasetReader(const std::vector<std::string>& shardPaths, int batchSize, unsigned int seed)
+    : batchSize_(std::max(1, batchSize)), rng_(seed)
+{
+    for (const auto& path : shardPaths) {
+        std::ifstream ifs(path, std::ios::binary | std::ios::ate);
+        if (!ifs.is_open()) {
+            std::cerr << "Error: Could not open demo shard " << path << std::endl;
+            continue;
+        }
+        const long long fileBytes = (long long)ifs.tellg();
+        ifs.seekg(0);
+
+        char magic[4];
+        uint32_t header[3] = {0, 0, 0};
+        ifs.read(magic, sizeof(magic));
+        ifs.read(reinterpret_cast<char*>(header), sizeof(header));
+        if (!ifs || std::memcmp(magic, SHARD_MAGIC, sizeof(magic)) != 0 || header[0] != SHARD_VERSION) {
+            std::cerr << "Skipping invalid demo shard " << path << std::endl;
+            continue;
+        }
+        if (featureCount_ == 0) featureCount_ = (int)header[1];
+        if ((int)header[1] != featureCount_) {
+            std::cerr << "Skipping demo shard " << path << " with " << header[1]
+                      << " features (expected " << featureCount_ << ")" << std::endl;
+            continue;
+        }
+
+        const long long records = (fileBytes - HEADER_BYTES) / (long long)recordBytes(featureCount_);
+        const int shardIdx = (int)shards_.size();
+        shards_.push_back({path, records});
+        for (long long first = 0; first < records; first += CHUNK_RECORDS) {
+            chunks_.push_back({shardIdx, first, (int)std::min<long long>(CHUNK_RECORDS, records - first)});
+        }
+        totalRecords_ += records;
+    }
+}
+
+DemoDatasetReader::~DemoDatasetReader() {
+    stopPrefetch();
+}
+
+void DemoDatasetReader::stopPrefetch() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    cv_.notify_all();
+    if (worker_.joinable()) worker_.join();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    queue_.clear();
+    stop_ = false;
+    producerDone_ = true;
+}
+
+void DemoDatasetReader::startEpoch() {
+    stopPrefetch();
+
+    std::vector<Chunk> order = chunks_;
+    std::shuffle(order.begin(), order.end(), rng_);
+    producerDone_ = false;
+    worker_ = std::thread(&DemoDatasetReader::prefetchLoop, this, std::move(order), (unsigned int)rng_());
+}
+
+bool DemoDatasetReader::nextBatch(DemoBatch& batch) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [&] { return !queue_.empty() || producerDone_; });
+    if (queue_.empty()) return false;
+
+    batch = std::move(queue_.front());
+    queue_.pop_front();
+    lock.unlock();
+    cv_.notify_all();
+    return true;
+}
+
+void DemoDatasetReader::prefetchLoop(std::vector<Chunk> order, unsigned int seed) {
+    std::mt19937 rng(seed);
+    std::vector<std::ifstream> files(shards_.size());
+    const size_t rowBytes = recordBytes(featureCount_);
+
+    std::vector<char> raw;
+    std::vector<int> perm;
+    DemoBatch pending;
+    pending.featureCount = featureCount_;
+
+    auto publish = [&](DemoBatch&& b) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [&] { return stop_ || (int)queue_.size() < MAX_QUEUED_BATCHES; });
+        if (stop_) return false;
+        queue_.push_back(std::move(b));
+        lock.unlock();
+        cv_.notify_all();
+        return true;
+    };
+
+    for (size_t c = 0; c < order.size(); c += SHUFFLE_WINDOW_CHUNKS) {
+        // Read a window of chunks into memory
+        raw.clear();
+        const size_t end = std::min(order.size(), c + SHUFFLE_WINDOW_CHUNKS);
+        for (size_t i = c; i < end; ++i) {
+            const Chunk& chunk = order[i];
+            std::ifstream& ifs = files[chunk.shard];
+            if (!ifs.is_open()) ifs.open(shards_[chunk.shard].path, std::ios::binary);
+
+            const size_t offset = raw.size();
+            raw.resize(offset + chunk.count * rowBytes);
+            ifs.seekg(HEADER_BYTES + chunk.first * (long long)rowBytes);
+            ifs.read(raw.data() + offset, (std::streamsize)(chunk.count * rowBytes));
+            if (!ifs) {
+                raw.resize(offset);
+                ifs.clear();
+            }
+        }
+
+        // Shuffle records within the window and cut them into batches
+        const int rows = (int)(raw.size() / rowBytes);
+        perm.resize(rows);
+        for (int i = 0; i < rows; ++i) perm[i] = i;
+        std::shuffle(perm.begin(), perm.end(), rng);
+
+        for (int i = 0; i < rows; ++i) {
+            const char* rec = raw.data() + (size_t)perm[i] * rowBytes;
+            const size_t base = pending.features.size();
+            pending.features.resize(base + featureCount_);
+            std::memcpy(pending.features.data() + base, rec, featureCount_ * sizeof(float));
+            pending.actions.push_back((uint8_t)rec[featureCount_ * sizeof(float)]);
+
+            if (pending.size() == batchSize_) {
+                if (!publish(std::move(pending))) return;
+                pending = DemoBatch();
+                pending.featureCount = featureCount_;
+            }
+        }
+    }
+    if (pending.size() > 0 && !publish(std::move(pending))) return;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        producerDone_ = true;
+    }
+    cv_.notify_all();
+}
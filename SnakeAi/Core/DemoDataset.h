@@ -0,0 +1,85 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <deque>
+#include <fstream>
+#include <random>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+// Demonstration shard layout (native byte order):
+//   header : "SNKD" | uint32 version | uint32 featureCount | uint32 reserved
+//   records: float features[featureCount] | uint8 action, repeated until EOF
+// Shards are append-only, so generators can stream without knowing the final
+// count, and a truncated trailing record from a killed writer is ignored.
+
+struct DemoBatch {
+    int featureCount = 0;
+    std::vector<float> features; // size() * featureCount values, row-major
+    std::vector<uint8_t> actions;
+
+    int size() const { return (int)actions.size(); }
+    const float* row(int i) const { return features.data() + (size_t)i * featureCount; }
+};
+
+class DemoShardWriter {
+public:
+    ~DemoShardWriter() { close(); }
+
+    bool open(const std::string& path, int featureCount);
+    void write(const std::vector<double>& features, int action);
+    void close();
+
+    long long count() const { return count_; }
+
+private:
+    std::ofstream ofs_;
+    int featureCount_ = 0;
+    long long count_ = 0;
+    std::vector<char> buffer_;
+};
+
+/**
+ * @brief Streams (state, action) batches from a set of shards.
+ * Every epoch visits all records once in a fresh random order: chunk order is
+ * shuffled globally and records are shuffled within a window of chunks. A
+ * background thread reads and assembles batches ahead of the consumer.
+ */
+class DemoDatasetReader {
+public:
+    DemoDatasetReader(const std::vector<std::string>& shardPaths, int batchSize, unsigned int seed);
+    ~DemoDatasetReader();
+
+    int featureCount() const { return featureCount_; }
+    long long size() const { return totalRecords_; }
+
+    void startEpoch();
+    bool nextBatch(DemoBatch& batch); // false once the epoch is exhausted
+
+private:
+    struct Shard { std::string path; long long records; };
+    struct Chunk { int shard; long long first; int count; };
+
+    void prefetchLoop(std::vector<Chunk> order, unsigned int seed);
+    void stopPrefetch();
+
+    static const int CHUNK_RECORDS = 4096;
+    static const int SHUFFLE_WINDOW_CHUNKS = 8;
+    static const int MAX_QUEUED_BATCHES = 8;
+
+    std::vector<Shard> shards_;
+    std::vector<Chunk> chunks_;
+    int featureCount_ = 0;
+    int batchSize_;
+    long long totalRecords_ = 0;
+    std::mt19937 rng_;
+
+    std::thread worker_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<DemoBatch> queue_;
+    bool producerDone_ = true;
+    bool stop_ = false;
+};
@@ -0,0 +1,105 @@
+#include "HamiltonianSolver.h"
+#include <utility>
+
+HamiltonianSolver::HamiltonianSolver(int rows, int cols) : rows_(rows), cols_(cols) {
+    buildCycle();
+}
+
+void HamiltonianSolver::buildCycle() {
+    // Build the cycle on a board with an even number of rows; transpose when
+    // only the column count is even.
+    const bool transpose = (rows_ % 2 != 0) && (cols_ % 2 == 0);
+    const int R = transpose ? cols_ : rows_;
+    const int C = transpose ? rows_ : cols_;
+    const bool oddBoard = (R % 2 != 0);
+
+    std::vector<sf::Vector2i> path; // (col, row) in the R x C frame
+    path.reserve(R * C);
+    for (int c = 0; c < C; ++c) path.push_back({c, 0});
+
+    // Serpentine over columns 1..C-1. On odd boards the last two rows are
+    // handled separately, so the serpentine stops at row R-3.
+    const int lastSerpentineRow = oddBoard ? R - 3 : R - 1;
+    for (int r = 1; r <= lastSerpentineRow; ++r) {
+        if (r % 2 == 1) for (int c = C - 1; c >= 1; --c) path.push_back({c, r});
+        else            for (int c = 1; c < C; ++c)      path.push_back({c, r});
+    }
+
+    if (oddBoard) {
+        // Skip the corner (C-1, R-1) and zigzag vertically through the last two rows:
+        // (C-1, R-2) -> (C-2, R-2) -> (C-2, R-1) -> (C-3, R-1) -> (C-3, R-2) -> ...
+        path.push_back({C - 1, R - 2});
+        for (int c = C - 2, k = 0; c >= 1; --c, ++k) {
+            if (k % 2 == 0) { path.push_back({c, R - 2}); path.push_back({c, R - 1}); }
+            else            { path.push_back({c, R - 1}); path.push_back({c, R - 2}); }
+        }
+    }
+
+    // Return along column 0 back to the start.
+    for (int r = R - 1; r >= 1; --r) path.push_back({0, r});
+
+    cycleLength_ = (int)path.size();
+    order_.assign(rows_ * cols_, 0);
+    for (int i = 0; i < cycleLength_; ++i) {
+        sf::Vector2i p = path[i];
+        if (transpose) std::swap(p.x, p.y);
+        order_[p.y * cols_ + p.x] = i;
+    }
+
+    if (oddBoard) {
+        // The skipped corner borrows the slot of its diagonal neighbour: both sit
+        // between (C-1, R-2) and (C-2, R-1) in cycle order.
+        sf::Vector2i corner = {C - 1, R - 1};
+        sf::Vector2i diagonal = {C - 2, R - 2};
+        if (transpose) { std::swap(corner.x, corner.y); std::swap(diagonal.x, diagonal.y); }
+        order_[corner.y * cols_ + corner.x] = order_[diagonal.y * cols_ + diagonal.x];
+    }
+}
+
+sf::Vector2i HamiltonianSolver::findMove(const SnakeGame& game) const {
+    const auto& grid = game.getGrid();
+    const auto& body = game.getSnakeBody();
+    const sf::Vector2i head = body.front();
+    const sf::Vector2i tail = body.back();
+    const sf::Vector2i food = game.getFoodPos();
+    const int length = (int)body.size();
+
+    const int headIdx = cycleIndex(head);
+    const int tailDist = length > 1 ? distance(headIdx, cycleIndex(tail)) : cycleLength_;
+    const int foodDist = food.x >= 0 ? distance(headIdx, cycleIndex(food)) : cycleLength_;
+
+    // Shortcuts are only taken while the snake covers less than half the cycle,
+    // and always leave some slack in front of the tail for growth.
+    const bool allowShortcuts = length * 2 < cycleLength_;
+    const int slack = 4;
+
+    sf::Vector2i best = {0, 0};
+    int bestDist = -1;
+    bool bestIsFood = false;
+
+    const sf::Vector2i dirs[4] = {{0, -1}, {0, 1}, {-1, 0}, {1, 0}};
+    for (const auto& d : dirs) {
+        sf::Vector2i next = head + d;
+        if (next.x < 0 || next.x >= cols_ || next.y < 0 || next.y >= rows_) continue;
+        if (grid[next.y][next.x].type == NodeType::Snake && (next != tail || length == 2)) continue;
+
+        const int stepDist = distance(headIdx, cycleIndex(next));
+        if (stepDist == 0) continue; // the shared corner/diagonal slot when already on it
+
+        if (stepDist != 1) {
+            // A shortcut must not jump over the tail or past the food, and must not
+            // land on the food's slot through the other cell of the shared slot.
+            if (!allowShortcuts) continue;
+            if (stepDist > foodDist || (stepDist == foodDist && next != food)) continue;
+            if (stepDist >= tailDist - slack) continue;
+        }
+
+        const bool isFood = (next == food);
+        if (stepDist > bestDist || (stepDist == bestDist && isFood && !bestIsFood)) {
+            best = d;
+            bestDist = stepDist;
+            bestIsFood = isFood;
+        }
+    }
+    return best;
+}
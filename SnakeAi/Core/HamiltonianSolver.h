@@ -0,0 +1,35 @@
+#pragma once
+#include <vector>
+#include <SFML/System.hpp>
+#include "SnakeGame.h"
+
+/**
+ * @brief Expert policy that follows a precomputed Hamiltonian cycle and takes
+ * shortcuts towards the food whenever they cannot cut off the tail.
+ *
+ * The cycle order is built once per board size; every decision afterwards is a
+ * handful of table lookups, so it can drive millions of steps per second.
+ * Boards where both dimensions are odd have no Hamiltonian cycle. There the
+ * bottom-right corner and its diagonal neighbour share one cycle slot: the
+ * corner lies on the regular path, and the diagonal cell is only entered when
+ * the food sits on it.
+ */
+class HamiltonianSolver {
+public:
+    HamiltonianSolver(int rows = Config::GRID_ROWS, int cols = Config::GRID_COLS);
+
+    // Returns the absolute direction to move in, or {0, 0} if every move is fatal.
+    sf::Vector2i findMove(const SnakeGame& game) const;
+
+    int cycleIndex(sf::Vector2i p) const { return order_[p.y * cols_ + p.x]; }
+    int cycleLength() const { return cycleLength_; }
+
+private:
+    void buildCycle();
+    int distance(int from, int to) const { return (to - from + cycleLength_) % cycleLength_; }
+
+    int rows_;
+    int cols_;
+    int cycleLength_ = 0;
+    std::vector<int> order_; // cycle index per cell (row-major)
+};
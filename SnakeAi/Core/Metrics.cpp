@@ -0,0 +1,125 @@
+#include "Metrics.h"
+#include "Checkpoint.h"
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+Histogram::Histogram(std::vector<double> bounds, size_t window)
+    : bounds_(std::move(bounds)), buckets_(bounds_.size() + 1, 0), windowSize_(std::max<size_t>(1, window)) {
+    std::sort(bounds_.begin(), bounds_.end());
+    window_.reserve(windowSize_);
+}
+
+void Histogram::observe(double value) {
+    const size_t bucket = std::lower_bound(bounds_.begin(), bounds_.end(), value) - bounds_.begin();
+    std::lock_guard<std::mutex> lock(mutex_);
+    buckets_[bucket]++;
+    sum_ += value;
+    count_++;
+    if (window_.size() < windowSize_) window_.push_back(value);
+    else window_[next_] = value;
+    next_ = (next_ + 1) % windowSize_;
+}
+
+Histogram::Summary Histogram::recent() const {
+    std::vector<double> values;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        values = window_;
+    }
+    Summary s;
+    s.count = values.size();
+    if (values.empty()) return s;
+
+    std::sort(values.begin(), values.end());
+    double total = 0.0;
+    for (double v : values) total += v;
+    auto quantile = [&](double q) { return values[std::min(values.size() - 1, (size_t)(q * values.size()))]; };
+    s.mean = total / values.size();
+    s.p50 = quantile(0.50);
+    s.p90 = quantile(0.90);
+    s.p99 = quantile(0.99);
+    s.max = values.back();
+    return s;
+}
+
+std::vector<double> Histogram::exponentialBounds(double start, double factor, int count) {
+    std::vector<double> bounds;
+    for (int i = 0; i < count; ++i, start *= factor) bounds.push_back(start);
+    return bounds;
+}
+
+Counter& MetricsRegistry::counter(const std::string& name, const std::string& help) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Entry& e = entries_[name];
+    if (!e.counter) { e.help = help; e.counter = std::make_unique<Counter>(); }
+    return *e.counter;
+}
+
+Gauge& MetricsRegistry::gauge(const std::string& name, const std::string& help) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Entry& e = entries_[name];
+    if (!e.gauge) { e.help = help; e.gauge = std::make_unique<Gauge>(); }
+    return *e.gauge;
+}
+
+Histogram& MetricsRegistry::histogram(const std::string& name, const std::string& help, std::vector<double> bounds, size_t window) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Entry& e = entries_[name];
+    if (!e.histogram) { e.help = help; e.histogram = std::make_unique<Histogram>(std::move(bounds), window); }
+    return *e.histogram;
+}
+
+namespace {
+    std::string number(double v) {
+        if (std::isinf(v)) return v > 0 ? "+Inf" : "-Inf";
+        if (std::isnan(v)) return "NaN";
+        std::ostringstream oss;
+        oss.precision(10);
+        oss << v;
+        return oss.str();
+    }
+}
+
+std::string MetricsRegistry::prometheusText() const {
+    std::ostringstream out;
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& [name, e] : entries_) {
+        out << "# HELP " << name << " " << e.help << "\n";
+        if (e.counter) {
+            out << "# TYPE " << name << " counter\n" << name << " " << number(e.counter->value()) << "\n";
+        } else if (e.gauge) {
+            out << "# TYPE " << name << " gauge\n" << name << " " << number(e.gauge->value()) << "\n";
+        } else if (e.histogram) {
+            const Histogram& h = *e.histogram;
+            std::vector<unsigned long long> buckets;
+            double sum;
+            unsigned long long count;
+            {
+                std::lock_guard<std::mutex> hlock(h.mutex_);
+                buckets = h.buckets_;
+                sum = h.sum_;
+                count = h.count_;
+            }
+            out << "# TYPE " << name << " histogram\n";
+            unsigned long long cumulative = 0;
+            for (size_t i = 0; i < buckets.size(); ++i) {
+                cumulative += buckets[i];
+                const double le = i < h.bounds_.size() ? h.bounds_[i] : INFINITY;
+                out << name << "_bucket{le=\"" << number(le) << "\"} " << cumulative << "\n";
+            }
+            out << name << "_sum " << number(sum) << "\n" << name << "_count " << count << "\n";
+
+            const Histogram::Summary s = h.recent();
+            out << "# HELP " << name << "_window " << e.help << " (last " << s.count << " observations)\n"
+                << "# TYPE " << name << "_window gauge\n";
+            const std::pair<const char*, double> stats[] = {{"mean", s.mean}, {"p50", s.p50}, {"p90", s.p90}, {"p99", s.p99}, {"max", s.max}};
+            for (const auto& [stat, value] : stats) out << name << "_window{stat=\"" << stat << "\"} " << number(value) << "\n";
+        }
+    }
+    return out.str();
+}
+
+bool MetricsRegistry::writeFile(const std::string& path) const {
+    return writeFileAtomically(path, prometheusText(), false);
+}
@@ -0,0 +1,92 @@
+#pragma once
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/** @brief Monotonically increasing total (games played, steps taken). */
+class Counter {
+public:
+    void add(double amount = 1.0) { value_.fetch_add(amount, std::memory_order_relaxed); }
+    double value() const { return value_.load(std::memory_order_relaxed); }
+private:
+    std::atomic<double> value_{0.0};
+};
+
+/** @brief Last observed value of something that goes up and down. */
+class Gauge {
+public:
+    void set(double value) { value_.store(value, std::memory_order_relaxed); }
+    double value() const { return value_.load(std::memory_order_relaxed); }
+private:
+    std::atomic<double> value_{0.0};
+};
+
+/**
+ * @brief Cumulative bucketed distribution (exported the Prometheus way) plus a
+ * rolling window of the most recent observations for summaries.
+ */
+class Histogram {
+public:
+    struct Summary {
+        size_t count = 0;
+        double mean = 0.0;
+        double p50 = 0.0;
+        double p90 = 0.0;
+        double p99 = 0.0;
+        double max = 0.0;
+    };
+
+    // bounds: ascending bucket upper limits (+Inf is implicit)
+    Histogram(std::vector<double> bounds, size_t window);
+
+    void observe(double value);
+    Summary recent() const; // over the rolling window only
+
+    // Exponential bucket limits: start, start*factor, ... (count of them)
+    static std::vector<double> exponentialBounds(double start, double factor, int count);
+
+private:
+    friend class MetricsRegistry;
+
+    std::vector<double> bounds_;
+    std::vector<unsigned long long> buckets_; // per bucket, not cumulative
+    double sum_ = 0.0;
+    unsigned long long count_ = 0;
+
+    std::vector<double> window_;
+    size_t windowSize_;
+    size_t next_ = 0;
+
+    mutable std::mutex mutex_;
+};
+
+/**
+ * @brief Named metrics of one process, exported as Prometheus text.
+ * Registration returns a reference that stays valid for the registry's
+ * lifetime; updating a metric never touches the registry itself.
+ */
+class MetricsRegistry {
+public:
+    Counter& counter(const std::string& name, const std::string& help);
+    Gauge& gauge(const std::string& name, const std::string& help);
+    Histogram& histogram(const std::string& name, const std::string& help, std::vector<double> bounds, size_t window = 1000);
+
+    // Text exposition format; histograms also export <name>_window{stat="..."} gauges
+    std::string prometheusText() const;
+    // Atomically replaces path (e.g. for the node-exporter textfile collector)
+    bool writeFile(const std::string& path) const;
+
+private:
+    struct Entry {
+        std::string help;
+        std::unique_ptr<Counter> counter;
+        std::unique_ptr<Gauge> gauge;
+        std::unique_ptr<Histogram> histogram;
+    };
+
+    std::map<std::string, Entry> entries_;
+    mutable std::mutex mutex_;
+};
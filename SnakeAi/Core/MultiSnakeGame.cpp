@@ -0,0 +1,176 @@
+#include "MultiSnakeGame.h"
+#include <algorithm>
+#include <cstdlib>
+
+MultiSnakeGame::MultiSnakeGame(int snakes, int rows, int cols, int foodCount)
+    : rows_(rows), cols_(cols), rng_(std::random_device{}()) {
+    // Every snake and every piece of food needs a cell of its own at reset
+    const int cells = std::max(2, rows_ * cols_);
+    int count = std::max(1, snakes);
+    if (foodCount > 0) {
+        foodCount_ = std::min(foodCount, cells - 1);
+        count = std::min(count, cells - foodCount_);
+    } else {
+        count = std::min(count, cells / 2);
+        foodCount_ = count;
+    }
+    snakes_.resize(count);
+    reset();
+}
+
+void MultiSnakeGame::reset() {
+    grid_.assign(rows_, std::vector<Node>(cols_));
+    for (int r = 0; r < rows_; ++r) {
+        for (int c = 0; c < cols_; ++c) {
+            grid_[r][c] = {NodeType::Empty, r, c};
+        }
+    }
+    owner_.assign(rows_ * cols_, -1);
+    claims_.assign(rows_ * cols_, -1);
+    food_.clear();
+    for (auto& snake : snakes_) snake = Snake{};
+    for (int i = 0; i < (int)snakes_.size(); ++i) place(i);
+    for (int k = 0; k < foodCount_; ++k) spawnFood();
+}
+
+int MultiSnakeGame::aliveCount() const {
+    return (int)std::count_if(snakes_.begin(), snakes_.end(), [](const Snake& s) { return s.alive; });
+}
+
+sf::Vector2i MultiSnakeGame::nearestFood(sf::Vector2i from) const {
+    sf::Vector2i best = {-1, -1};
+    int bestDist = 1 << 30;
+    for (const auto& f : food_) {
+        const int dist = std::abs(f.x - from.x) + std::abs(f.y - from.y);
+        if (dist < bestDist) { bestDist = dist; best = f; }
+    }
+    return best;
+}
+
+void MultiSnakeGame::respawn(int index) {
+    if (!snakes_[index].alive) place(index);
+}
+
+void MultiSnakeGame::place(int index) {
+    Snake& snake = snakes_[index];
+    sf::Vector2i pos;
+    if (!randomFreeCell(pos)) return; // board full, stays dead
+    snake.body.assign(1, pos);
+    // Head towards the middle so a fresh snake is not pointed straight at a wall
+    snake.direction = std::abs(pos.x - cols_ / 2) >= std::abs(pos.y - rows_ / 2)
+        ? sf::Vector2i(pos.x < cols_ / 2 ? 1 : -1, 0)
+        : sf::Vector2i(0, pos.y < rows_ / 2 ? 1 : -1);
+    snake.alive = true;
+    grid_[pos.y][pos.x].type = NodeType::Snake;
+    owner_[cell(pos)] = index;
+}
+
+bool MultiSnakeGame::randomFreeCell(sf::Vector2i& out) {
+    std::uniform_int_distribution<> row(0, rows_ - 1), col(0, cols_ - 1);
+    for (int tries = 0; tries < 32; ++tries) {
+        sf::Vector2i pos = {col(rng_), row(rng_)};
+        if (grid_[pos.y][pos.x].type == NodeType::Empty) { out = pos; return true; }
+    }
+
+    std::vector<sf::Vector2i> emptyCells;
+    for (int r = 0; r < rows_; ++r) {
+        for (int c = 0; c < cols_; ++c) {
+            if (grid_[r][c].type == NodeType::Empty) emptyCells.push_back({c, r});
+        }
+    }
+    if (emptyCells.empty()) return false;
+    out = emptyCells[std::uniform_int_distribution<>(0, (int)emptyCells.size() - 1)(rng_)];
+    return true;
+}
+
+void MultiSnakeGame::spawnFood() {
+    sf::Vector2i pos;
+    if (!randomFreeCell(pos)) return;
+    grid_[pos.y][pos.x].type = NodeType::Food;
+    food_.push_back(pos);
+}
+
+const std::vector<MultiSnakeGame::Outcome>& MultiSnakeGame::step(const std::vector<sf::Vector2i>& moves) {
+    const int count = (int)snakes_.size();
+    outcomes_.assign(count, Outcome::Died);
+    targets_.assign(count, {-1, -1});
+    vacates_.assign(count, 0);
+
+    // 1. Targets; a tail moves unless its snake is about to eat
+    for (int i = 0; i < count; ++i) {
+        const Snake& snake = snakes_[i];
+        if (!snake.alive) continue;
+        const sf::Vector2i target = snake.body.front() + moves[i];
+        targets_[i] = target;
+        const bool eats = inside(target) && grid_[target.y][target.x].type == NodeType::Food;
+        vacates_[i] = !eats;
+        outcomes_[i] = eats ? Outcome::Ate : Outcome::Moved;
+    }
+
+    // 2. Walls and bodies
+    for (int i = 0; i < count; ++i) {
+        if (!snakes_[i].alive) continue;
+        const sf::Vector2i target = targets_[i];
+        if (!inside(target)) { outcomes_[i] = Outcome::Died; continue; }
+        const int owner = owner_[cell(target)];
+        if (owner >= 0 && !(vacates_[owner] && target == snakes_[owner].body.back())) outcomes_[i] = Outcome::Died;
+    }
+
+    // 3. Head-on collisions: every snake entering a contested cell dies
+    for (int i = 0; i < count; ++i) {
+        if (!snakes_[i].alive || !inside(targets_[i])) continue;
+        int& claim = claims_[cell(targets_[i])];
+        if (claim < 0) claim = i;
+        else outcomes_[claim] = outcomes_[i] = Outcome::Died;
+    }
+    for (int i = 0; i < count; ++i) {
+        if (snakes_[i].alive && inside(targets_[i])) claims_[cell(targets_[i])] = -1;
+    }
+
+    // 4. Heads passing through each other (only possible between single-cell snakes)
+    for (int i = 0; i < count; ++i) {
+        if (!snakes_[i].alive || !inside(targets_[i])) continue;
+        const int other = owner_[cell(targets_[i])];
+        if (other >= 0 && other != i && snakes_[other].alive && targets_[other] == snakes_[i].body.front()) {
+            outcomes_[i] = outcomes_[other] = Outcome::Died;
+        }
+    }
+
+    // 5. Apply: clear the dead, then advance the survivors
+    for (int i = 0; i < count; ++i) {
+        Snake& snake = snakes_[i];
+        if (!snake.alive || outcomes_[i] != Outcome::Died) continue;
+        for (const auto& p : snake.body) {
+            if (owner_[cell(p)] == i) {
+                owner_[cell(p)] = -1;
+                grid_[p.y][p.x].type = NodeType::Empty;
+            }
+        }
+        snake.body.clear();
+        snake.alive = false;
+    }
+    int eaten = 0;
+    for (int i = 0; i < count; ++i) {
+        Snake& snake = snakes_[i];
+        if (!snake.alive) continue;
+        if (outcomes_[i] == Outcome::Moved) {
+            const sf::Vector2i tail = snake.body.back();
+            snake.body.pop_back();
+            // Another snake may already have moved its head into this cell
+            if (owner_[cell(tail)] == i) {
+                owner_[cell(tail)] = -1;
+                grid_[tail.y][tail.x].type = NodeType::Empty;
+            }
+        } else {
+            food_.erase(std::find(food_.begin(), food_.end(), targets_[i]));
+            eaten++;
+        }
+        const sf::Vector2i head = targets_[i];
+        snake.body.push_front(head);
+        snake.direction = moves[i];
+        owner_[cell(head)] = i;
+        grid_[head.y][head.x].type = NodeType::Snake;
+    }
+    for (int k = 0; k < eaten; ++k) spawnFood();
+    return outcomes_;
+}
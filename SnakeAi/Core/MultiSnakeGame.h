@@ -0,0 +1,78 @@
+#pragma once
+#include <vector>
+#include <deque>
+#include <random>
+#include <SFML/System.hpp>
+#include "Node.h"
+#include "Config.h"
+
+/**
+ * @brief Several snakes on one board, competing for shared food.
+ *
+ * All snakes move at once. A tick is resolved against the board as it is after
+ * every tail that is due to move has moved, so following another snake's tail
+ * is safe. A snake dies when it:
+ *  - leaves the board,
+ *  - enters a body cell that is still occupied after the tails move (its own or
+ *    another snake's),
+ *  - moves onto the same cell as another snake's head (all snakes involved die),
+ *  - swaps cells with another snake's head.
+ * Dead snakes are cleared from the board at the end of the tick and stay dead
+ * until respawn() is called. Eaten food is replaced right away.
+ */
+class MultiSnakeGame {
+public:
+    enum class Outcome { Moved, Ate, Died };
+
+    struct Snake {
+        std::deque<sf::Vector2i> body; // front is the head
+        sf::Vector2i direction = {1, 0};
+        bool alive = false;
+    };
+
+    // foodCount 0 keeps one piece of food per snake on the board. The snake count is
+    // lowered until snakes and food fit on the board; see snakeCount().
+    MultiSnakeGame(int snakes, int rows = Config::GRID_ROWS, int cols = Config::GRID_COLS, int foodCount = 0);
+
+    void reset();
+    void seed(unsigned int value) { rng_.seed(value); }
+
+    // Moves every living snake by moves[i] (ignored for dead snakes) and returns
+    // what happened to each; dead snakes report Died.
+    const std::vector<Outcome>& step(const std::vector<sf::Vector2i>& moves);
+
+    // Puts a dead snake back as a single cell on a random free square
+    void respawn(int index);
+
+    // Getters
+    const std::vector<std::vector<Node>>& getGrid() const { return grid_; }
+    const Snake& getSnake(int index) const { return snakes_[index]; }
+    int snakeCount() const { return (int)snakes_.size(); }
+    int aliveCount() const;
+    const std::vector<sf::Vector2i>& getFood() const { return food_; }
+    sf::Vector2i nearestFood(sf::Vector2i from) const; // {-1, -1} when there is none
+    int getRows() const { return rows_; }
+    int getCols() const { return cols_; }
+
+private:
+    bool inside(sf::Vector2i p) const { return p.x >= 0 && p.x < cols_ && p.y >= 0 && p.y < rows_; }
+    int cell(sf::Vector2i p) const { return p.y * cols_ + p.x; }
+    void place(int index);
+    void spawnFood();
+    bool randomFreeCell(sf::Vector2i& out);
+
+    int rows_;
+    int cols_;
+    int foodCount_;
+    std::vector<std::vector<Node>> grid_;
+    std::vector<int> owner_; // snake occupying each cell, -1 if none
+    std::vector<Snake> snakes_;
+    std::vector<sf::Vector2i> food_;
+    std::mt19937 rng_;
+
+    // Per-tick scratch
+    std::vector<Outcome> outcomes_;
+    std::vector<sf::Vector2i> targets_;
+    std::vector<char> vacates_;
+    std::vector<int> claims_; // first snake heading into each cell this tick, -1 if none
+};
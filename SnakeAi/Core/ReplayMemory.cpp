@@ -0,0 +1,522 @@
+#include "ReplayMemory.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    const uint32_t VERSION = 1;
+    const uint64_t EMPTY_SLOT = ~0ull;
+    enum Encoding : uint32_t { Raw = 0, XorZeroRun = 1 };
+
+    struct FileHeader {
+        char magic[4];
+        uint32_t version;
+        uint32_t featureCount;
+        uint32_t chunkRecords;
+        uint64_t slotCount;
+        uint64_t slotBytes;
+        uint64_t pushed;
+    };
+
+    struct SlotEntry {
+        uint64_t seq;
+        uint32_t bytes;
+        uint32_t records;
+        uint32_t encoding;
+        uint32_t pad;
+        uint64_t checksum;
+    };
+
+    uint16_t toHalf(float value) {
+        uint32_t x;
+        std::memcpy(&x, &value, sizeof(x));
+        const uint32_t sign = (x >> 16) & 0x8000;
+        const int32_t rawExp = (int32_t)((x >> 23) & 0xFF);
+        uint32_t mant = x & 0x7FFFFF;
+        if (rawExp == 0xFF) return (uint16_t)(sign | 0x7C00 | (mant ? 0x200 : 0)); // inf, nan
+        const int32_t exp = rawExp - 127 + 15;
+        if (exp >= 31) return (uint16_t)(sign | 0x7C00);
+        if (exp <= 0) {
+            // Subnormal half (or zero), rounded to nearest even
+            if (exp < -10) return (uint16_t)sign;
+            mant |= 0x800000;
+            const int shift = 14 - exp;
+            uint32_t half = mant >> shift;
+            const uint32_t rem = mant & ((1u << shift) - 1);
+            const uint32_t halfway = 1u << (shift - 1);
+            if (rem > halfway || (rem == halfway && (half & 1))) half++;
+            return (uint16_t)(sign | half);
+        }
+        uint32_t half = sign | ((uint32_t)exp << 10) | (mant >> 13);
+        const uint32_t rem = mant & 0x1FFF;
+        if (rem > 0x1000 || (rem == 0x1000 && (half & 1))) half++; // a carry correctly bumps the exponent
+        return (uint16_t)half;
+    }
+
+    float fromHalf(uint16_t h) {
+        const uint32_t sign = (uint32_t)(h & 0x8000) << 16;
+        int32_t exp = (h >> 10) & 0x1F;
+        uint32_t mant = h & 0x3FF;
+        uint32_t x;
+        if (exp == 0) {
+            if (mant == 0) {
+                x = sign;
+            } else {
+                exp = 1;
+                while (!(mant & 0x400)) { mant <<= 1; exp--; }
+                mant &= 0x3FF;
+                x = sign | ((uint32_t)(exp + 127 - 15) << 23) | (mant << 13);
+            }
+        } else if (exp == 31) {
+            x = sign | 0x7F800000 | (mant << 13);
+        } else {
+            x = sign | ((uint32_t)(exp + 127 - 15) << 23) | (mant << 13);
+        }
+        float value;
+        std::memcpy(&value, &x, sizeof(value));
+        return value;
+    }
+
+    uint64_t fnv1a(const uint8_t* data, size_t size) {
+        uint64_t hash = 0xcbf29ce484222325ull;
+        for (size_t i = 0; i < size; ++i) hash = (hash ^ data[i]) * 0x100000001b3ull;
+        return hash;
+    }
+
+    // Chunk codec: bytes are visited column by column (byte b of every record),
+    // each XORed with the same byte of the previous record, so slowly changing
+    // fields turn into zero runs. A zero byte is followed by a varint of the
+    // number of further zeros; other bytes are copied.
+    void compressChunk(const uint8_t* records, int count, int recordBytes, std::vector<uint8_t>& out) {
+        out.clear();
+        size_t zeros = 0;
+        auto flushZeros = [&] {
+            if (zeros == 0) return;
+            out.push_back(0);
+            size_t more = zeros - 1;
+            do {
+                uint8_t byte = more & 0x7F;
+                more >>= 7;
+                out.push_back(byte | (more ? 0x80 : 0));
+            } while (more);
+            zeros = 0;
+        };
+        for (int b = 0; b < recordBytes; ++b) {
+            uint8_t prev = 0;
+            for (int i = 0; i < count; ++i) {
+                const uint8_t cur = records[(size_t)i * recordBytes + b];
+                const uint8_t v = cur ^ prev;
+                prev = cur;
+                if (v == 0) { zeros++; continue; }
+                flushZeros();
+                out.push_back(v);
+            }
+        }
+        flushZeros();
+    }
+
+    bool decompressChunk(const uint8_t* in, size_t size, int count, int recordBytes, uint8_t* out) {
+        const size_t total = (size_t)count * recordBytes;
+        size_t pos = 0, produced = 0;
+        auto put = [&](uint8_t v) {
+            const size_t b = produced / count, i = produced % count;
+            const uint8_t prev = i > 0 ? out[(i - 1) * recordBytes + b] : 0;
+            out[i * recordBytes + b] = v ^ prev;
+            produced++;
+        };
+        while (pos < size && produced < total) {
+            const uint8_t v = in[pos++];
+            if (v != 0) { put(v); continue; }
+            size_t more = 0;
+            int shift = 0;
+            uint8_t byte;
+            do {
+                if (pos >= size || shift > 56) return false;
+                byte = in[pos++];
+                more |= (size_t)(byte & 0x7F) << shift;
+                shift += 7;
+            } while (byte & 0x80);
+            if (produced + more + 1 > total) return false;
+            for (size_t k = 0; k <= more; ++k) put(0);
+        }
+        return produced == total && pos == size;
+    }
+}
+
+ReplayMemory::Settings ReplayMemory::settingsFor(const TrainingConfig& config) {
+    Settings settings;
+    settings.featureCount = AiAgent::stateSize(config.features);
+    settings.capacity = config.replayMemorySize;
+    settings.hotCapacity = config.replayHotSize;
+    settings.spillFile = config.replaySpillFile;
+    settings.prefetchBatch = config.replaySpillFile.empty() ? 0 : config.batchSize;
+    return settings;
+}
+
+ReplayMemory::ReplayMemory(const Settings& settings)
+    : settings_(settings), recordBytes_(4 * settings.featureCount + 5) {
+    settings_.capacity = std::max(1LL, settings_.capacity);
+    hotCapacity_ = settings_.capacity;
+    scratch_.resize(recordBytes_);
+
+    if (!settings_.spillFile.empty() && openSpill(settings_.spillFile)) {
+        // The hot tier holds whole chunks so a completed chunk can always be spilled from it
+        hotCapacity_ = std::max<long long>(CHUNK_RECORDS, (settings_.hotCapacity + CHUNK_RECORDS - 1) / CHUNK_RECORDS * CHUNK_RECORDS);
+        restoreHot();
+    }
+    if (settings_.prefetchBatch > 0) {
+        prefetcher_ = std::thread(&ReplayMemory::prefetchLoop, this, (unsigned int)std::random_device{}());
+    }
+}
+
+ReplayMemory::~ReplayMemory() {
+    if (prefetcher_.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(queueMutex_);
+            stop_ = true;
+        }
+        queueCv_.notify_all();
+        prefetcher_.join();
+    }
+    flush();
+    closeSpill();
+}
+
+long long ReplayMemory::retainedStart() const {
+    if (!map_) return hotStart_;
+    // slotCount_ - 1 complete chunks plus the one being filled
+    const long long current = pushed_ / CHUNK_RECORDS;
+    return std::max(0LL, (current - (slotCount_ - 1)) * CHUNK_RECORDS);
+}
+
+long long ReplayMemory::size() const {
+    std::lock_guard<std::mutex> lock(hotMutex_);
+    return pushed_ - retainedStart();
+}
+
+double ReplayMemory::diskBytesPerTransition() const {
+    if (!map_) return 0.0;
+    std::lock_guard<std::mutex> lock(diskMutex_);
+    const SlotEntry* slots = reinterpret_cast<const SlotEntry*>(map_ + sizeof(FileHeader));
+    double bytes = 0.0, records = 0.0;
+    for (long long s = 0; s < slotCount_; ++s) {
+        if (slots[s].seq == EMPTY_SLOT) continue;
+        bytes += slots[s].bytes;
+        records += slots[s].records;
+    }
+    return records > 0 ? bytes / records : 0.0;
+}
+
+void ReplayMemory::push(const Experience& exp) {
+    // Quantize: fp16 features, float reward, action | done << 2
+    uint8_t* p = scratch_.data();
+    const int n = settings_.featureCount;
+    for (int i = 0; i < n; ++i) {
+        const uint16_t s = toHalf(i < (int)exp.state.size() ? (float)exp.state[i] : 0.0f);
+        const uint16_t t = toHalf(i < (int)exp.nextState.size() ? (float)exp.nextState[i] : 0.0f);
+        std::memcpy(p + 2 * i, &s, 2);
+        std::memcpy(p + 2 * (n + i), &t, 2);
+    }
+    const float reward = (float)exp.reward;
+    std::memcpy(p + 4 * n, &reward, 4);
+    p[4 * n + 4] = (uint8_t)((exp.action & 3) | (exp.done ? 4 : 0));
+
+    {
+        std::lock_guard<std::mutex> lock(hotMutex_);
+        const size_t offset = (size_t)(pushed_ % hotCapacity_) * recordBytes_;
+        if (hot_.size() < offset + recordBytes_) {
+            hot_.resize(std::min<size_t>((size_t)hotCapacity_ * recordBytes_, std::max(offset + recordBytes_, hot_.size() * 2)));
+        }
+        std::memcpy(hot_.data() + offset, p, recordBytes_);
+        pushed_++;
+        hotStart_ = std::max(hotStart_, pushed_ - hotCapacity_);
+    }
+    if (map_ && pushed_ % CHUNK_RECORDS == 0) writeChunk(pushed_ / CHUNK_RECORDS - 1, CHUNK_RECORDS);
+}
+
+void ReplayMemory::decode(const uint8_t* record, Experience& out) const {
+    const int n = settings_.featureCount;
+    out.state.resize(n);
+    out.nextState.resize(n);
+    for (int i = 0; i < n; ++i) {
+        uint16_t s, t;
+        std::memcpy(&s, record + 2 * i, 2);
+        std::memcpy(&t, record + 2 * (n + i), 2);
+        out.state[i] = fromHalf(s);
+        out.nextState[i] = fromHalf(t);
+    }
+    float reward;
+    std::memcpy(&reward, record + 4 * n, 4);
+    out.reward = reward;
+    out.action = record[4 * n + 4] & 3;
+    out.done = (record[4 * n + 4] & 4) != 0;
+}
+
+void ReplayMemory::sample(int count, std::mt19937& rng, std::vector<Experience>& out) {
+    if (prefetcher_.joinable() && count == settings_.prefetchBatch && size() > count) {
+        std::unique_lock<std::mutex> lock(queueMutex_);
+        while (true) {
+            queueCv_.wait(lock, [&] { return !ready_.empty(); });
+            const long long drawnAt = ready_.front().first;
+            out = std::move(ready_.front().second);
+            ready_.pop_front();
+            queueCv_.notify_all();
+            if (drawnAt + MAX_BATCH_AGE >= pushed_) return; // else stale after a long pause in sampling
+        }
+    }
+    fillBatch(count, rng, inlineSampler_, out);
+}
+
+long long ReplayMemory::fillBatch(int count, std::mt19937& rng, Sampler& sampler, std::vector<Experience>& out) {
+    refreshReservoir(rng, sampler, sampler.drawn / ROTATE_SAMPLES != (sampler.drawn + count) / ROTATE_SAMPLES);
+    sampler.drawn += count;
+
+    std::lock_guard<std::mutex> lock(hotMutex_);
+    const long long start = retainedStart();
+    const long long total = pushed_ - start;
+    out.clear();
+    if (total <= 0) return pushed_;
+
+    auto hotRecord = [&](long long r) { return hot_.data() + (size_t)(r % hotCapacity_) * recordBytes_; };
+    if (total <= count) {
+        for (long long r = std::max(start, hotStart_); r < pushed_; ++r) decode(hotRecord(r), out.emplace_back());
+        return pushed_;
+    }
+
+    long long reservoirRecords = 0;
+    for (const auto& chunk : sampler.reservoir) reservoirRecords += chunk.records;
+    out.resize(count);
+    for (int i = 0; i < count; ++i) {
+        long long r = start + (long long)(rng() % (unsigned long long)total);
+        if (r < hotStart_ && reservoirRecords > 0) {
+            // Disk tier: stand in with a random record of the decoded chunks
+            long long k = (long long)(rng() % (unsigned long long)reservoirRecords);
+            for (const auto& chunk : sampler.reservoir) {
+                if (k < chunk.records) { decode(chunk.data.data() + (size_t)k * recordBytes_, out[i]); break; }
+                k -= chunk.records;
+            }
+            continue;
+        }
+        if (r < hotStart_) r = hotStart_ + (long long)(rng() % (unsigned long long)(pushed_ - hotStart_));
+        decode(hotRecord(r), out[i]);
+    }
+    return pushed_;
+}
+
+// Keeps up to RESERVOIR_CHUNKS decoded disk chunks; replaceOne swaps the oldest for a random other one
+void ReplayMemory::refreshReservoir(std::mt19937& rng, Sampler& sampler, bool replaceOne) {
+    if (!map_) return;
+    long long firstSeq, endSeq;
+    {
+        std::lock_guard<std::mutex> lock(hotMutex_);
+        firstSeq = retainedStart() / CHUNK_RECORDS;
+        endSeq = (hotStart_ + CHUNK_RECORDS - 1) / CHUNK_RECORDS; // chunks holding anything older than the hot tier
+    }
+    if (endSeq <= firstSeq) { sampler.reservoir.clear(); return; }
+
+    auto load = [&](DecodedChunk& slot) {
+        for (int tries = 0; tries < 8; ++tries) {
+            const long long seq = firstSeq + (long long)(rng() % (unsigned long long)(endSeq - firstSeq));
+            if (readChunk(seq, slot)) return true;
+        }
+        return false;
+    };
+
+    // Drop chunks that fell out of the ring
+    sampler.reservoir.erase(std::remove_if(sampler.reservoir.begin(), sampler.reservoir.end(),
+                                           [&](const DecodedChunk& c) { return c.seq < firstSeq; }),
+                            sampler.reservoir.end());
+    if (replaceOne && !sampler.reservoir.empty() && (int)sampler.reservoir.size() >= RESERVOIR_CHUNKS) {
+        DecodedChunk fresh;
+        if (load(fresh)) {
+            sampler.reservoir.erase(sampler.reservoir.begin());
+            sampler.reservoir.push_back(std::move(fresh));
+        }
+    }
+    const long long available = endSeq - firstSeq;
+    while ((long long)sampler.reservoir.size() < std::min<long long>(RESERVOIR_CHUNKS, available)) {
+        DecodedChunk fresh;
+        if (!load(fresh)) break;
+        sampler.reservoir.push_back(std::move(fresh));
+    }
+}
+
+void ReplayMemory::prefetchLoop(unsigned int seed) {
+    std::mt19937 rng(seed);
+    Sampler sampler;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(queueMutex_);
+            queueCv_.wait(lock, [&] { return stop_ || (int)ready_.size() < MAX_QUEUED_BATCHES; });
+            if (stop_) return;
+        }
+        if (size() <= settings_.prefetchBatch) {
+            // Too little to sample from yet; the learner draws inline meanwhile
+            std::unique_lock<std::mutex> lock(queueMutex_);
+            queueCv_.wait_for(lock, std::chrono::milliseconds(5), [&] { return stop_; });
+            continue;
+        }
+        std::vector<Experience> batch;
+        const long long drawnAt = fillBatch(settings_.prefetchBatch, rng, sampler, batch);
+        {
+            std::lock_guard<std::mutex> lock(queueMutex_);
+            ready_.emplace_back(drawnAt, std::move(batch));
+        }
+        queueCv_.notify_all();
+    }
+}
+
+void ReplayMemory::flush() {
+    if (!map_) return;
+    const int partial = (int)(pushed_ % CHUNK_RECORDS);
+    if (partial > 0) writeChunk(pushed_ / CHUNK_RECORDS, partial);
+#ifndef _WIN32
+    ::msync(map_, mapBytes_, MS_SYNC);
+#endif
+}
+
+void ReplayMemory::writeChunk(long long seq, int records) {
+    // Only this thread writes the hot tier, so it can be read without the lock
+    const size_t rawBytes = (size_t)records * recordBytes_;
+    std::vector<uint8_t> raw(rawBytes);
+    for (int i = 0; i < records; ++i) {
+        const long long r = seq * CHUNK_RECORDS + i;
+        std::memcpy(raw.data() + (size_t)i * recordBytes_, hot_.data() + (size_t)(r % hotCapacity_) * recordBytes_, recordBytes_);
+    }
+    compressChunk(raw.data(), records, recordBytes_, compressBuffer_);
+    const bool packed = compressBuffer_.size() < rawBytes;
+    const uint8_t* data = packed ? compressBuffer_.data() : raw.data();
+    const size_t bytes = packed ? compressBuffer_.size() : rawBytes;
+
+    std::lock_guard<std::mutex> lock(diskMutex_);
+    FileHeader* header = reinterpret_cast<FileHeader*>(map_);
+    SlotEntry& slot = reinterpret_cast<SlotEntry*>(map_ + sizeof(FileHeader))[seq % slotCount_];
+    slot.seq = EMPTY_SLOT; // invalid while the data is being replaced
+    std::memcpy(map_ + dataOffset_ + (size_t)(seq % slotCount_) * slotBytes_, data, bytes);
+    slot.bytes = (uint32_t)bytes;
+    slot.records = (uint32_t)records;
+    slot.encoding = packed ? XorZeroRun : Raw;
+    slot.checksum = fnv1a(data, bytes);
+    slot.seq = (uint64_t)seq;
+    header->pushed = (uint64_t)(seq * CHUNK_RECORDS + records);
+}
+
+bool ReplayMemory::readChunk(long long seq, DecodedChunk& out) const {
+    std::vector<uint8_t> stored;
+    SlotEntry slot;
+    {
+        std::lock_guard<std::mutex> lock(diskMutex_);
+        slot = reinterpret_cast<const SlotEntry*>(map_ + sizeof(FileHeader))[seq % slotCount_];
+        if (slot.seq != (uint64_t)seq || slot.records == 0 || slot.records > CHUNK_RECORDS || slot.bytes > slotBytes_) return false;
+        const uint8_t* data = map_ + dataOffset_ + (size_t)(seq % slotCount_) * slotBytes_;
+        stored.assign(data, data + slot.bytes);
+    }
+    if (fnv1a(stored.data(), stored.size()) != slot.checksum) return false;
+
+    out.seq = seq;
+    out.records = (int)slot.records;
+    out.data.resize((size_t)slot.records * recordBytes_);
+    if (slot.encoding == Raw) {
+        if (stored.size() != out.data.size()) return false;
+        std::memcpy(out.data.data(), stored.data(), stored.size());
+        return true;
+    }
+    return decompressChunk(stored.data(), stored.size(), out.records, recordBytes_, out.data.data());
+}
+
+// Reloads the newest stored chunks into the hot tier after reopening a spill file
+void ReplayMemory::restoreHot() {
+    const FileHeader* header = reinterpret_cast<const FileHeader*>(map_);
+    pushed_ = (long long)header->pushed;
+
+    DecodedChunk chunk;
+    const long long partial = pushed_ % CHUNK_RECORDS;
+    if (partial > 0 && !(readChunk(pushed_ / CHUNK_RECORDS, chunk) && chunk.records == partial)) {
+        pushed_ -= partial; // the unfinished chunk did not survive; drop it
+    }
+
+    hotStart_ = pushed_;
+    hot_.resize((size_t)hotCapacity_ * recordBytes_);
+    const long long oldest = retainedStart() / CHUNK_RECORDS;
+    for (long long seq = (pushed_ - 1) / CHUNK_RECORDS; pushed_ > 0 && seq >= oldest; --seq) {
+        const long long first = seq * CHUNK_RECORDS;
+        if (pushed_ - first > hotCapacity_ || !readChunk(seq, chunk)) break;
+        if (first + chunk.records != std::min(pushed_, first + CHUNK_RECORDS)) break;
+        for (int i = 0; i < chunk.records; ++i) {
+            std::memcpy(hot_.data() + (size_t)((first + i) % hotCapacity_) * recordBytes_,
+                        chunk.data.data() + (size_t)i * recordBytes_, recordBytes_);
+        }
+        hotStart_ = first;
+    }
+    if (pushed_ > 0) {
+        std::cout << "Replay memory: resumed " << (pushed_ - retainedStart()) << " transitions from " << settings_.spillFile << std::endl;
+    }
+}
+
+bool ReplayMemory::openSpill(const std::string& path) {
+#ifdef _WIN32
+    std::cerr << "Error: Replay spill files are not supported on Windows; keeping the replay memory in RAM." << std::endl;
+    return false;
+#else
+    slotCount_ = (settings_.capacity + CHUNK_RECORDS - 1) / CHUNK_RECORDS + 1;
+    slotBytes_ = ((size_t)CHUNK_RECORDS * recordBytes_ + 4095) / 4096 * 4096;
+    dataOffset_ = (sizeof(FileHeader) + (size_t)slotCount_ * sizeof(SlotEntry) + 4095) / 4096 * 4096;
+    mapBytes_ = dataOffset_ + (size_t)slotCount_ * slotBytes_;
+
+    fd_ = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd_ < 0) {
+        std::cerr << "Error: Could not open replay spill file " << path << std::endl;
+        return false;
+    }
+    struct stat st;
+    const bool exists = ::fstat(fd_, &st) == 0 && st.st_size > 0;
+    const bool sized = exists && (size_t)st.st_size == mapBytes_;
+    // A fresh file is sparse: only the parts of each slot that get written take space
+    if (!sized && (::ftruncate(fd_, 0) != 0 || ::ftruncate(fd_, (off_t)mapBytes_) != 0)) {
+        std::cerr << "Error: Could not size replay spill file " << path << std::endl;
+        closeSpill();
+        return false;
+    }
+    void* map = ::mmap(nullptr, mapBytes_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (map == MAP_FAILED) {
+        std::cerr << "Error: Could not map replay spill file " << path << std::endl;
+        closeSpill();
+        return false;
+    }
+    map_ = static_cast<uint8_t*>(map);
+
+    FileHeader* header = reinterpret_cast<FileHeader*>(map_);
+    const bool matches = sized && std::memcmp(header->magic, "SNKR", 4) == 0 && header->version == VERSION &&
+                         header->featureCount == (uint32_t)settings_.featureCount && header->chunkRecords == CHUNK_RECORDS &&
+                         header->slotCount == (uint64_t)slotCount_ && header->slotBytes == slotBytes_;
+    if (!matches) {
+        if (exists) std::cout << "Replay memory: " << path << " has a different layout, starting it over." << std::endl;
+        std::memcpy(header->magic, "SNKR", 4);
+        header->version = VERSION;
+        header->featureCount = (uint32_t)settings_.featureCount;
+        header->chunkRecords = CHUNK_RECORDS;
+        header->slotCount = (uint64_t)slotCount_;
+        header->slotBytes = slotBytes_;
+        header->pushed = 0;
+        SlotEntry* slots = reinterpret_cast<SlotEntry*>(map_ + sizeof(FileHeader));
+        for (long long s = 0; s < slotCount_; ++s) slots[s] = SlotEntry{EMPTY_SLOT, 0, 0, Raw, 0, 0};
+    }
+    return true;
+#endif
+}
+
+void ReplayMemory::closeSpill() {
+#ifndef _WIN32
+    if (map_) ::munmap(map_, mapBytes_);
+    if (fd_ >= 0) ::close(fd_);
+#endif
+    map_ = nullptr;
+    fd_ = -1;
+}
@@ -0,0 +1,127 @@
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "AiAgent.h"
+
+/**
+ * @brief Replay memory that scales to millions of transitions.
+ *
+ * Transitions are stored quantized: features as fp16, the reward as float, and
+ * action + done packed into one byte (4 * features + 5 bytes per transition,
+ * 141 for the ray features). The newest transitions live in a RAM ring (the hot
+ * tier). With a spill file, every completed chunk of CHUNK_RECORDS transitions
+ * is also compressed into a ring of fixed-size slots in an mmap'ed file, which
+ * holds everything older than the hot tier. flush() writes the unfinished chunk
+ * too. Reopening the same file (same feature count and capacity) resumes with
+ * the stored transitions, so a restarted trainer keeps its experience.
+ *
+ * Sampling is uniform over the hot tier and the disk tier in proportion to their
+ * sizes. Disk samples come from a small reservoir of decoded chunks, one of
+ * which is replaced with a random other chunk every few hundred samples, so the
+ * disk is read a chunk at a time rather than a record at a time. With
+ * prefetchBatch > 0, a background thread assembles batches of that size ahead
+ * of the learner.
+ *
+ * Spill file layout (native byte order):
+ *   header : "SNKR" | uint32 version | uint32 featureCount | uint32 chunkRecords |
+ *            uint64 slotCount | uint64 slotBytes | uint64 pushed
+ *   slots  : slotCount x {uint64 seq | uint32 bytes | uint32 records | uint32 encoding | uint32 pad | uint64 checksum}
+ *   data   : slotCount x slotBytes, page aligned; chunk seq lives in slot seq % slotCount
+ */
+class ReplayMemory {
+public:
+    struct Settings {
+        int featureCount = AiAgent::STATE_SIZE;
+        long long capacity = 10000;      // transitions kept in total (up to a chunk more when spilling)
+        long long hotCapacity = 1 << 16; // newest transitions kept in RAM when spilling
+        std::string spillFile;           // empty keeps everything in RAM
+        int prefetchBatch = 0;           // batch size prepared in the background, 0 samples inline
+    };
+
+    static const int CHUNK_RECORDS = 4096;
+
+    // replay_* keys of the config; a spill file also turns on prefetching of batchSize batches
+    static Settings settingsFor(const TrainingConfig& config);
+
+    explicit ReplayMemory(const Settings& settings);
+    ~ReplayMemory(); // flushes
+
+    ReplayMemory(const ReplayMemory&) = delete;
+    ReplayMemory& operator=(const ReplayMemory&) = delete;
+
+    void push(const Experience& exp);
+
+    // `count` transitions drawn uniformly with replacement, or every stored
+    // transition while there are no more than `count`
+    void sample(int count, std::mt19937& rng, std::vector<Experience>& out);
+
+    // Persists the unfinished chunk and the header; no-op without a spill file
+    void flush();
+
+    long long size() const;
+    long long pushed() const { return pushed_; }
+    bool spilling() const { return map_ != nullptr; }
+    int featureCount() const { return settings_.featureCount; }
+    int recordBytes() const { return recordBytes_; }
+    double diskBytesPerTransition() const; // compressed size of the spilled chunks
+
+private:
+    struct DecodedChunk {
+        long long seq = -1;
+        int records = 0;
+        std::vector<uint8_t> data;
+    };
+    struct Sampler {
+        std::vector<DecodedChunk> reservoir;
+        long long drawn = 0;
+    };
+
+    bool openSpill(const std::string& path);
+    void closeSpill();
+    void restoreHot();
+    void writeChunk(long long seq, int records);
+    bool readChunk(long long seq, DecodedChunk& out) const;
+
+    long long retainedStart() const;
+    long long fillBatch(int count, std::mt19937& rng, Sampler& sampler, std::vector<Experience>& out); // returns pushed_ at the draw
+    void refreshReservoir(std::mt19937& rng, Sampler& sampler, bool replaceOne);
+    void decode(const uint8_t* record, Experience& out) const;
+    void prefetchLoop(unsigned int seed);
+
+    static const int RESERVOIR_CHUNKS = 8;
+    static const int ROTATE_SAMPLES = 256;
+    static const int MAX_QUEUED_BATCHES = 4;
+    static const int MAX_BATCH_AGE = 1024; // pushes after which a queued batch is thrown away
+
+    Settings settings_;
+    int recordBytes_;
+    long long hotCapacity_;
+    std::vector<uint8_t> hot_; // record r at r % hotCapacity_
+    long long hotStart_ = 0;   // oldest transition still in the hot tier
+    long long pushed_ = 0;
+    std::vector<uint8_t> scratch_;
+    mutable std::mutex hotMutex_;
+
+    // Spill file
+    uint8_t* map_ = nullptr;
+    size_t mapBytes_ = 0;
+    int fd_ = -1;
+    long long slotCount_ = 0;
+    size_t slotBytes_ = 0;
+    size_t dataOffset_ = 0;
+    mutable std::mutex diskMutex_;
+    std::vector<uint8_t> compressBuffer_;
+
+    Sampler inlineSampler_;
+    std::thread prefetcher_;
+    std::mutex queueMutex_;
+    std::condition_variable queueCv_;
+    std::deque<std::pair<long long, std::vector<Experience>>> ready_; // (pushed when drawn, batch)
+    bool stop_ = false;
+};
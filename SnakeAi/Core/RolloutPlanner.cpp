@@ -0,0 +1,163 @@
+#include "RolloutPlanner.h"
+#include "AiAgent.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <random>
+
+namespace {
+    uint64_t splitmix(uint64_t& state) {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+}
+
+RolloutPlanner::RolloutPlanner(const Settings& settings) : settings_(settings) {
+    int workers = settings_.workers;
+    if (workers <= 0) workers = ThreadPool::availableCpus() - 1; // the calling thread searches too
+    stats_.resize(workers + 1);
+    for (int i = 0; i < workers; ++i) threads_.emplace_back(&RolloutPlanner::workerLoop, this, i + 1);
+    seed_ = std::random_device{}();
+}
+
+RolloutPlanner::~RolloutPlanner() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    wake_.notify_all();
+    for (auto& t : threads_) t.join();
+}
+
+sf::Vector2i RolloutPlanner::plan(const SnakeGame& game, sf::Vector2i direction, const std::vector<double>& qValues) {
+    if (!CompactGame::fits(game)) return AiAgent::toDirection(0, direction);
+
+    root_ = CompactGame::from(game);
+    int legalCount = 0;
+    for (int a = 0; a < 3; ++a) {
+        moves_[a] = AiAgent::toDirection(a, direction);
+        legal_[a] = !root_.isFatal(moves_[a]);
+        legalCount += legal_[a];
+    }
+    // Nothing to search: every move but one (or all of them) dies right away
+    if (legalCount <= 1) {
+        for (int a = 0; a < 3; ++a) if (legal_[a]) return moves_[a];
+        return moves_[0];
+    }
+
+    for (auto& s : stats_) s = WorkerStats{};
+    deadline_ = Clock::now() + std::chrono::microseconds((long long)(settings_.budgetMs * 1000.0));
+    seed_ = splitmix(seed_);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        busy_ = (int)threads_.size();
+        generation_++;
+    }
+    wake_.notify_all();
+    search(0);
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_.wait(lock, [&] { return busy_ == 0; });
+    }
+
+    // Softmax of the network's Q-values acts as a prior over the moves
+    double prior[3] = {0, 0, 0};
+    if (qValues.size() == 3) {
+        const double maxQ = *std::max_element(qValues.begin(), qValues.end());
+        double total = 0.0;
+        for (int a = 0; a < 3; ++a) total += (prior[a] = std::exp(qValues[a] - maxQ));
+        for (double& p : prior) p /= total;
+    }
+
+    int best = -1;
+    double bestScore = 0.0;
+    lastRollouts_ = 0;
+    for (int a = 0; a < 3; ++a) {
+        if (!legal_[a]) continue;
+        double sum = 0.0;
+        long long count = 0;
+        for (const auto& s : stats_) { sum += s.sum[a]; count += s.count[a]; }
+        lastRollouts_ += count;
+        const double value = count > 0 ? sum / count : 0.0;
+        const double score = value + settings_.priorWeight * prior[a];
+        if (best < 0 || score > bestScore) { best = a; bestScore = score; }
+    }
+    return moves_[best];
+}
+
+void RolloutPlanner::workerLoop(int id) {
+    long long seen = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [&] { return stop_ || generation_ != seen; });
+            if (stop_) return;
+            seen = generation_;
+        }
+        search(id);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            busy_--;
+        }
+        done_.notify_one();
+    }
+}
+
+// Round-robin over the legal moves until the deadline
+void RolloutPlanner::search(int id) {
+    WorkerStats& stats = stats_[id];
+    uint64_t rng = seed_ ^ ((uint64_t)id * 0xD1B54A32D192ED03ull);
+    int a = id % 3;
+    CompactGame game;
+    do {
+        while (!legal_[a]) a = (a + 1) % 3;
+        root_.cloneInto(game);
+        game.reseed(splitmix(rng));
+
+        double value = 0.0;
+        const CompactGame::StepResult first = game.step(moves_[a]);
+        if (first == CompactGame::Died) value = -settings_.deathPenalty;
+        else value = (first == CompactGame::Ate ? settings_.foodReward : 0.0) + settings_.gamma * rollout(game, rng);
+
+        stats.sum[a] += value;
+        stats.count[a]++;
+        a = (a + 1) % 3;
+    } while (Clock::now() < deadline_);
+}
+
+// Fast default policy: usually the safe move closest to the food, sometimes a random safe one
+double RolloutPlanner::rollout(CompactGame& game, uint64_t& rng) const {
+    double value = 0.0;
+    double discount = 1.0;
+    for (int step = 0; step < settings_.depth; ++step) {
+        const sf::Vector2i head = game.headPos();
+        const sf::Vector2i food = game.foodPos();
+        if (food.x < 0) break; // board cleared
+
+        sf::Vector2i safe[3];
+        int safeCount = 0;
+        for (int a = 0; a < 3; ++a) {
+            const sf::Vector2i d = AiAgent::toDirection(a, game.direction);
+            if (!game.isFatal(d)) safe[safeCount++] = d;
+        }
+        if (safeCount == 0) return value - discount * settings_.deathPenalty;
+
+        const uint64_t r = splitmix(rng);
+        sf::Vector2i move = safe[r % safeCount];
+        if ((r >> 32) % 5 != 0) {
+            int bestDist = 1 << 30;
+            for (int i = 0; i < safeCount; ++i) {
+                const sf::Vector2i p = head + safe[i];
+                const int dist = std::abs(p.x - food.x) + std::abs(p.y - food.y);
+                if (dist < bestDist) { bestDist = dist; move = safe[i]; }
+            }
+        }
+
+        if (game.step(move) == CompactGame::Ate) value += discount * settings_.foodReward;
+        discount *= settings_.gamma;
+    }
+    return value;
+}
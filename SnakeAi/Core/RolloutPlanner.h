@@ -0,0 +1,72 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <SFML/System.hpp>
+#include "CompactGame.h"
+#include "SnakeGame.h"
+
+/**
+ * @brief Picks a move by Monte-Carlo rollouts under a wall-clock budget.
+ * Each of the three relative moves is played out many times from a CompactGame
+ * clone with a fast food-seeking policy, on a pool of worker threads. The mean
+ * discounted return is combined with the network's Q-values as a prior.
+ * Workers check the deadline between rollouts, so a decision overruns its
+ * budget by at most one rollout of `depth` steps.
+ */
+class RolloutPlanner {
+public:
+    struct Settings {
+        int workers = 0;           // extra threads next to the caller, 0 = ThreadPool::availableCpus() - 1
+        double budgetMs = 5.0;     // per move
+        int depth = 60;            // rollout horizon in steps
+        double gamma = 0.97;
+        double foodReward = 1.0;
+        double deathPenalty = 3.0;
+        double priorWeight = 0.25; // weight of softmax(Q) in the final score
+    };
+
+    explicit RolloutPlanner(const Settings& settings);
+    ~RolloutPlanner();
+
+    // qValues: network outputs for the position (forward, left, right), may be empty.
+    // Returns an absolute direction; {0, 0} only if the board has no cells to move to.
+    sf::Vector2i plan(const SnakeGame& game, sf::Vector2i direction, const std::vector<double>& qValues);
+
+    long long lastRollouts() const { return lastRollouts_; }
+    const Settings& settings() const { return settings_; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct alignas(64) WorkerStats {
+        double sum[3];
+        long long count[3];
+    };
+
+    void workerLoop(int id);
+    void search(int id);
+    double rollout(CompactGame& game, uint64_t& rng) const;
+
+    Settings settings_;
+    std::vector<std::thread> threads_;
+    std::vector<WorkerStats> stats_; // slot 0 belongs to the calling thread
+
+    // Current search, written by plan() before workers are woken
+    CompactGame root_;
+    sf::Vector2i moves_[3];
+    bool legal_[3];
+    Clock::time_point deadline_;
+    uint64_t seed_ = 0;
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    long long generation_ = 0;
+    int busy_ = 0;
+    bool stop_ = false;
+    long long lastRollouts_ = 0;
+};
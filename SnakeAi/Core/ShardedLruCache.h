@@ -0,0 +1,77 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+/**
+ * @brief Bounded LRU map from 64-bit hashes to values, split into independently
+ * locked shards so concurrent workers rarely contend. Keys are expected to be
+ * well mixed already (Zobrist hashes); the top bits pick the shard.
+ */
+template <typename Value>
+class ShardedLruCache {
+public:
+    ShardedLruCache(size_t capacity, size_t shardCount = 16)
+        : shardCount_(shardCount), shards_(std::make_unique<Shard[]>(shardCount)) {
+        for (size_t i = 0; i < shardCount_; ++i) shards_[i].capacity = (capacity + shardCount_ - 1) / shardCount_;
+    }
+
+    bool get(uint64_t key, Value& out) {
+        Shard& shard = shardFor(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.index.find(key);
+        if (it == shard.index.end()) {
+            misses_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        shard.order.splice(shard.order.begin(), shard.order, it->second); // now most recent
+        out = it->second->second;
+        hits_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    void put(uint64_t key, const Value& value) {
+        Shard& shard = shardFor(key);
+        if (shard.capacity == 0) return;
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.index.find(key);
+        if (it != shard.index.end()) {
+            it->second->second = value;
+            shard.order.splice(shard.order.begin(), shard.order, it->second);
+            return;
+        }
+        if (shard.index.size() >= shard.capacity) {
+            // Recycle the least recently used node instead of allocating
+            auto last = std::prev(shard.order.end());
+            shard.index.erase(last->first);
+            last->first = key;
+            last->second = value;
+            shard.order.splice(shard.order.begin(), shard.order, last);
+        } else {
+            shard.order.emplace_front(key, value);
+        }
+        shard.index[key] = shard.order.begin();
+    }
+
+    uint64_t hits() const { return hits_.load(std::memory_order_relaxed); }
+    uint64_t misses() const { return misses_.load(std::memory_order_relaxed); }
+
+private:
+    struct Shard {
+        std::mutex mutex;
+        std::list<std::pair<uint64_t, Value>> order; // most recently used first
+        std::unordered_map<uint64_t, typename std::list<std::pair<uint64_t, Value>>::iterator> index;
+        size_t capacity = 0;
+    };
+
+    Shard& shardFor(uint64_t key) { return shards_[(key >> 48) % shardCount_]; }
+
+    size_t shardCount_;
+    std::unique_ptr<Shard[]> shards_;
+    std::atomic<uint64_t> hits_{0};
+    std::atomic<uint64_t> misses_{0};
+};
@@ -1,29 +1,69 @@
 #pragma once
 #include <vector>
+#include <algorithm>
+#include <bit>
 #include <cmath>
+#include <cstdint>
 #include <cstdlib>
 #include <fstream>
 #include <iostream>
+#include <string>
+#include <random>
+
+enum class Activation { Linear, ReLU, Tanh, FastTanh };
+
+inline const char* activationName(Activation a) {
+    switch (a) {
+        case Activation::Linear:   return "linear";
+        case Activation::ReLU:     return "relu";
+        case Activation::FastTanh: return "fasttanh";
+        default:                   return "tanh";
+    }
+}
+
+inline bool parseActivation(const std::string& name, Activation& out) {
+    if (name == "linear")        out = Activation::Linear;
+    else if (name == "relu")     out = Activation::ReLU;
+    else if (name == "tanh")     out = Activation::Tanh;
+    else if (name == "fasttanh") out = Activation::FastTanh;
+    else return false;
+    return true;
+}
+
+// Rational (Pade 7/6) approximation of tanh, clamped to +-1 beyond |x| = 4.97.
+// Max absolute error is about 1e-4, at the clamp point.
+inline double fastTanh(double x) {
+    if (x > 4.97) return 1.0;
+    if (x < -4.97) return -1.0;
+    const double x2 = x * x;
+    return x * (135135.0 + x2 * (17325.0 + x2 * (378.0 + x2))) /
+           (135135.0 + x2 * (62370.0 + x2 * (3150.0 + x2 * 28.0)));
+}
 
 struct Layer {
     int size;
     int prevSize;
+    Activation activation;
     std::vector<std::vector<double>> weights;
     std::vector<double> biases;
     std::vector<double> outputs;
     std::vector<double> deltas; // For backprop
 
-    Layer(int s, int ps) : size(s), prevSize(ps) {
+    Layer(int s, int ps, Activation act, std::mt19937& rng) : size(s), prevSize(ps), activation(act) {
         outputs.resize(size);
         deltas.resize(size);
         biases.resize(size);
         weights.resize(size, std::vector<double>(prevSize));
         
-        // Random init
+        // Random init. Tanh layers keep the original U(-1, 1); unbounded
+        // activations use He-uniform scaling so outputs do not explode.
+        const bool bounded = (act == Activation::Tanh || act == Activation::FastTanh);
+        const double scale = (bounded || prevSize == 0) ? 1.0 : std::sqrt(6.0 / prevSize);
+        std::uniform_real_distribution<double> uniform(-1.0, 1.0);
         for(int i=0; i<size; ++i) {
-            biases[i] = ((double)rand() / RAND_MAX) * 2.0 - 1.0;
+            biases[i] = bounded ? uniform(rng) : 0.0;
             for(int j=0; j<prevSize; ++j) {
-                weights[i][j] = ((double)rand() / RAND_MAX) * 2.0 - 1.0;
+                weights[i][j] = uniform(rng) * scale;
             }
         }
     }
@@ -33,15 +73,101 @@ class NeuralNetwork {
 public:
     std::vector<Layer> layers;
     double learningRate = 0.01;
+    std::mt19937 rng{std::random_device{}()}; // Weight initialisation
 
-    void addLayer(int size) {
+    void addLayer(int size, Activation activation = Activation::Tanh) {
         if (layers.empty()) {
             // Input layer has no weights/prevSize, conceptually just placeholders
             // But usually we just define input size separately. 
             // Let's assume the user adds Input Layer first with prevSize=0 (ignored)
-            layers.emplace_back(size, 0); 
+            layers.emplace_back(size, 0, Activation::Linear, rng); 
         } else {
-            layers.emplace_back(size, layers.back().size);
+            layers.emplace_back(size, layers.back().size, activation, rng);
+        }
+    }
+
+    // Per-thread scratch for the const passes below, so several threads can run
+    // one network at the same time
+    struct Workspace {
+        std::vector<std::vector<double>> outputs; // per layer
+        std::vector<std::vector<double>> deltas;
+        std::vector<int> active; // set input bits, for forwardBits()
+    };
+
+    // Summed loss gradients (in the update direction) of one or more samples
+    struct Gradient {
+        std::vector<std::vector<double>> weights; // per layer, row-major size x prevSize
+        std::vector<std::vector<double>> biases;
+
+        void clear() {
+            for (auto& w : weights) std::fill(w.begin(), w.end(), 0.0);
+            for (auto& b : biases) std::fill(b.begin(), b.end(), 0.0);
+        }
+        void add(const Gradient& other) {
+            for (size_t i = 0; i < weights.size(); ++i) {
+                for (size_t k = 0; k < weights[i].size(); ++k) weights[i][k] += other.weights[i][k];
+                for (size_t k = 0; k < biases[i].size(); ++k) biases[i][k] += other.biases[i][k];
+            }
+        }
+    };
+
+    void initGradient(Gradient& grad) const {
+        grad.weights.resize(layers.size());
+        grad.biases.resize(layers.size());
+        for (size_t i = 0; i < layers.size(); ++i) {
+            grad.weights[i].assign((size_t)layers[i].size * layers[i].prevSize, 0.0);
+            grad.biases[i].assign(i > 0 ? layers[i].size : 0, 0.0);
+        }
+    }
+
+    // Same as feedForward() but keeps its state in `ws`
+    const std::vector<double>& forward(const std::vector<double>& inputs, Workspace& ws) const {
+        ws.outputs.resize(layers.size());
+        ws.outputs[0] = inputs;
+        for (size_t i = 1; i < layers.size(); ++i) {
+            forwardLayer(layers[i], ws.outputs[i - 1], ws.outputs[i]);
+        }
+        return ws.outputs.back();
+    }
+
+    // Adds the gradient of the sample last passed to forward(ws) to `grad`.
+    // errors: as for backPropagateError(). Weights are left untouched.
+    void accumulateGradient(const std::vector<double>& errors, Workspace& ws, Gradient& grad) const {
+        ws.deltas.resize(layers.size());
+        const size_t last = layers.size() - 1;
+        ws.deltas[last].resize(layers[last].size);
+        for (int i = 0; i < layers[last].size; ++i) {
+            ws.deltas[last][i] = errors[i] * derivative(layers[last].activation, ws.outputs[last][i]);
+        }
+        for (size_t i = last - 1; i > 0; --i) {
+            const Layer& curr = layers[i];
+            const Layer& next = layers[i + 1];
+            ws.deltas[i].resize(curr.size);
+            for (int j = 0; j < curr.size; ++j) {
+                double error = 0.0;
+                for (int k = 0; k < next.size; ++k) error += ws.deltas[i + 1][k] * next.weights[k][j];
+                ws.deltas[i][j] = error * derivative(curr.activation, ws.outputs[i][j]);
+            }
+        }
+        for (size_t i = 1; i < layers.size(); ++i) {
+            const std::vector<double>& prev = ws.outputs[i - 1];
+            for (int j = 0; j < layers[i].size; ++j) {
+                const double delta = ws.deltas[i][j];
+                grad.biases[i][j] += delta;
+                double* row = &grad.weights[i][(size_t)j * layers[i].prevSize];
+                for (int k = 0; k < layers[i].prevSize; ++k) row[k] += delta * prev[k];
+            }
+        }
+    }
+
+    // One step along a summed gradient: weights += learningRate * grad
+    void applyGradient(const Gradient& grad) {
+        for (size_t i = 1; i < layers.size(); ++i) {
+            for (int j = 0; j < layers[i].size; ++j) {
+                layers[i].biases[j] += learningRate * grad.biases[i][j];
+                const double* row = &grad.weights[i][(size_t)j * layers[i].prevSize];
+                for (int k = 0; k < layers[i].prevSize; ++k) layers[i].weights[j][k] += learningRate * row[k];
+            }
         }
     }
 
@@ -50,30 +176,98 @@ public:
         if (inputs.size() != layers[0].size) return {};
         
         layers[0].outputs = inputs;
+        forwardFrom(1);
+        return layers.back().outputs;
+    }
 
-        // Forward prop
+    // Same result as feedForward() for an input made of bitCount 0/1 flags (packed
+    // in `bits`, LSB first) followed by denseCount ordinary values. The first layer
+    // only adds the weight columns of set bits, so a sparse binary input costs
+    // O(set bits) rather than O(inputs). Inference only: backPropagate() needs the
+    // dense input of a feedForward() call.
+    std::vector<double> feedForwardBits(const uint64_t* bits, int bitCount, const double* dense, int denseCount) {
+        if (layers.size() < 2 || bitCount + denseCount != layers[0].size) return {};
+        forwardFirstLayerBits(layers[1], bits, bitCount, dense, denseCount, activeInputs_, layers[1].outputs);
+        forwardFrom(2);
+        return layers.back().outputs;
+    }
+
+    // Same as feedForwardBits() but keeps its state in `ws`; empty on a size mismatch
+    const std::vector<double>& forwardBits(const uint64_t* bits, int bitCount, const double* dense, int denseCount, Workspace& ws) const {
+        ws.outputs.resize(layers.size());
+        if (layers.size() < 2 || bitCount + denseCount != layers[0].size) {
+            ws.outputs.back().clear();
+            return ws.outputs.back();
+        }
+        forwardFirstLayerBits(layers[1], bits, bitCount, dense, denseCount, ws.active, ws.outputs[1]);
+        for (size_t i = 2; i < layers.size(); ++i) forwardLayer(layers[i], ws.outputs[i - 1], ws.outputs[i]);
+        return ws.outputs.back();
+    }
+
+    // Forward pass for `count` inputs stored back to back; returns the outputs the
+    // same way (count x output size). Activations are kept feature-major (one
+    // row of `count` values per neuron), so every weight is loaded once per batch
+    // and the inner loop runs across the batch, where it vectorises. Each output
+    // is summed in the same order as feedForward(), so results match exactly.
+    // Leaves the per-layer state used by backPropagate() alone.
+    std::vector<double> feedForwardBatch(const std::vector<double>& inputs, int count) {
+        const int inputSize = layers.empty() ? 0 : layers[0].size;
+        if (layers.size() < 2 || count <= 0 || inputs.size() != (size_t)count * inputSize) return {};
+
+        batchIn_.resize(inputs.size());
+        for (int b = 0; b < count; ++b) {
+            for (int k = 0; k < inputSize; ++k) batchIn_[(size_t)k * count + b] = inputs[(size_t)b * inputSize + k];
+        }
         for (size_t i = 1; i < layers.size(); ++i) {
-            for (int j = 0; j < layers[i].size; ++j) {
-                double sum = layers[i].biases[j];
-                for (int k = 0; k < layers[i].prevSize; ++k) {
-                    sum += layers[i].weights[j][k] * layers[i-1].outputs[k];
+            const Layer& layer = layers[i];
+            batchOut_.resize((size_t)layer.size * count);
+            for (int j = 0; j < layer.size; ++j) {
+                double* out = &batchOut_[(size_t)j * count];
+                const double* w = layer.weights[j].data();
+                if (count < 8) {
+                    // Too few lanes to pay for the batch loop; plain dot products
+                    for (int b = 0; b < count; ++b) {
+                        double sum = layer.biases[j];
+                        for (int k = 0; k < layer.prevSize; ++k) sum += w[k] * batchIn_[(size_t)k * count + b];
+                        out[b] = sum;
+                    }
+                    continue;
+                }
+                for (int b = 0; b < count; ++b) out[b] = layer.biases[j];
+                for (int k = 0; k < layer.prevSize; ++k) {
+                    const double wk = w[k];
+                    const double* in = &batchIn_[(size_t)k * count];
+                    for (int b = 0; b < count; ++b) out[b] += wk * in[b];
                 }
-                // ReLU for hidden, Linear/Sigmoid for output? 
-                // Let's use Tanh or Sigmoid for stability in simple C++ implementations
-                layers[i].outputs[j] = std::tanh(sum); 
             }
+            activate(layer.activation, batchOut_);
+            std::swap(batchIn_, batchOut_);
         }
-        return layers.back().outputs;
+
+        const int outputSize = layers.back().size;
+        std::vector<double> outputs((size_t)count * outputSize);
+        for (int b = 0; b < count; ++b) {
+            for (int j = 0; j < outputSize; ++j) outputs[(size_t)b * outputSize + j] = batchIn_[(size_t)j * count + b];
+        }
+        return outputs;
     }
 
     void backPropagate(const std::vector<double>& targets) {
+        const Layer& outLayer = layers.back();
+        std::vector<double> errors(outLayer.size);
+        for (int i = 0; i < outLayer.size; ++i) {
+            errors[i] = targets[i] - outLayer.outputs[i];
+        }
+        backPropagateError(errors);
+    }
+
+    // errors: negative loss gradient w.r.t. the output activations of the last
+    // feedForward (targets - outputs for squared error).
+    void backPropagateError(const std::vector<double>& errors) {
         // Output layer gradients
         Layer& outLayer = layers.back();
         for (int i = 0; i < outLayer.size; ++i) {
-            double output = outLayer.outputs[i];
-            double error = targets[i] - output;
-            // Derivative of Tanh is 1 - output^2
-            outLayer.deltas[i] = error * (1 - output * output);
+            outLayer.deltas[i] = errors[i] * derivative(outLayer.activation, outLayer.outputs[i]);
         }
 
         // Hidden layer gradients
@@ -85,7 +279,7 @@ public:
                 for (int k = 0; k < next.size; ++k) {
                     error += next.deltas[k] * next.weights[k][j];
                 }
-                curr.deltas[j] = error * (1 - curr.outputs[j] * curr.outputs[j]);
+                curr.deltas[j] = error * derivative(curr.activation, curr.outputs[j]);
             }
         }
 
@@ -99,4 +293,72 @@ public:
             }
         }
     }
+
+private:
+    void forwardFrom(size_t firstLayer) {
+        for (size_t i = firstLayer; i < layers.size(); ++i) {
+            forwardLayer(layers[i], layers[i-1].outputs, layers[i].outputs);
+        }
+    }
+
+    static void forwardLayer(const Layer& layer, const std::vector<double>& prev, std::vector<double>& out) {
+        out.resize(layer.size);
+        for (int j = 0; j < layer.size; ++j) {
+            double sum = layer.biases[j];
+            const double* w = layer.weights[j].data();
+            for (int k = 0; k < layer.prevSize; ++k) {
+                sum += w[k] * prev[k];
+            }
+            out[j] = sum;
+        }
+        activate(layer.activation, out);
+    }
+
+    static void forwardFirstLayerBits(const Layer& first, const uint64_t* bits, int bitCount, const double* dense, int denseCount,
+                                      std::vector<int>& active, std::vector<double>& out) {
+        active.clear();
+        for (int w = 0; w < (bitCount + 63) / 64; ++w) {
+            for (uint64_t word = bits[w]; word != 0; word &= word - 1) {
+                active.push_back(w * 64 + std::countr_zero(word));
+            }
+        }
+        out.resize(first.size);
+        for (int j = 0; j < first.size; ++j) {
+            double sum = first.biases[j];
+            const double* w = first.weights[j].data();
+            for (int k : active) sum += w[k];
+            for (int k = 0; k < denseCount; ++k) sum += w[bitCount + k] * dense[k];
+            out[j] = sum;
+        }
+        activate(first.activation, out);
+    }
+
+    static void activate(Activation activation, std::vector<double>& out) {
+        switch (activation) {
+            case Activation::Linear:
+                break;
+            case Activation::ReLU:
+                for (double& v : out) v = v > 0.0 ? v : 0.0;
+                break;
+            case Activation::FastTanh:
+                for (double& v : out) v = fastTanh(v);
+                break;
+            default:
+                for (double& v : out) v = std::tanh(v);
+                break;
+        }
+    }
+
+    // Derivative expressed through the activation's output
+    static double derivative(Activation activation, double output) {
+        switch (activation) {
+            case Activation::Linear: return 1.0;
+            case Activation::ReLU:   return output > 0.0 ? 1.0 : 0.0;
+            default:                 return 1.0 - output * output; // tanh
+        }
+    }
+
+    std::vector<int> activeInputs_; // scratch for feedForwardBits
+    std::vector<double> batchIn_;   // scratch for feedForwardBatch
+    std::vector<double> batchOut_;
 };
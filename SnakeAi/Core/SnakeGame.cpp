@@ -2,7 +2,7 @@
 #include <random>
 #include <queue>
 
-SnakeGame::SnakeGame() {
+SnakeGame::SnakeGame(int rows, int cols) : rows_(rows), cols_(cols), keys_(&ZobristKeys::forBoard(rows_, cols_)), rng_(std::random_device{}()) {
     reset();
 }
 
@@ -18,10 +18,36 @@ void SnakeGame::reset() {
     const int startCol = cols_ / 2;
     snakeBody_.push_front({startCol, startRow});
     grid_[startRow][startCol].type = NodeType::Snake;
+    direction_ = {1, 0};
+    foodPos_ = {-1, -1};
+    hash_ = computeHash();
     spawnFood();
 }
 
+uint64_t SnakeGame::computeHash() const {
+    uint64_t hash = keys_->direction(direction_) ^ keys_->food(foodPos_);
+    for (const auto& p : snakeBody_) hash ^= keys_->body(p);
+    if (!snakeBody_.empty()) hash ^= keys_->head(snakeBody_.front()) ^ keys_->tail(snakeBody_.back());
+    return hash;
+}
+
 void SnakeGame::spawnFood() {
+    hash_ ^= keys_->food(foodPos_);
+    foodPos_ = {-1, -1};
+
+    // Random probes find a free cell almost immediately unless the board is nearly
+    // full, which keeps eating O(1) on large boards; the full scan is the fallback.
+    std::uniform_int_distribution<> row(0, rows_ - 1), col(0, cols_ - 1);
+    for (int tries = 0; tries < 32; ++tries) {
+        sf::Vector2i pos = {col(rng_), row(rng_)};
+        if (grid_[pos.y][pos.x].type == NodeType::Empty) {
+            grid_[pos.y][pos.x].type = NodeType::Food;
+            foodPos_ = pos;
+            hash_ ^= keys_->food(pos);
+            return;
+        }
+    }
+
     std::vector<sf::Vector2i> emptyCells;
     for (int r = 0; r < rows_; ++r) {
         for (int c = 0; c < cols_; ++c) {
@@ -29,23 +55,14 @@ void SnakeGame::spawnFood() {
         }
     }
     if (!emptyCells.empty()) {
-        static std::random_device rd;
-        static std::mt19937 gen(rd());
         std::uniform_int_distribution<> dis(0, (int)emptyCells.size() - 1);
-        sf::Vector2i pos = emptyCells[dis(gen)];
+        sf::Vector2i pos = emptyCells[dis(rng_)];
         grid_[pos.y][pos.x].type = NodeType::Food;
+        foodPos_ = pos;
+        hash_ ^= keys_->food(pos);
     }
 }
 
-sf::Vector2i SnakeGame::getFoodPos() const {
-    for(int r=0; r<rows_; ++r) {
-        for(int c=0; c<cols_; ++c) {
-            if (grid_[r][c].type == NodeType::Food) return {c, r};
-        }
-    }
-    return {-1, -1};
-}
-
 bool SnakeGame::step(sf::Vector2i direction) {
     sf::Vector2i head = snakeBody_.front();
     sf::Vector2i newHead = head + direction;
@@ -58,9 +75,11 @@ bool SnakeGame::step(sf::Vector2i direction) {
     // Collision check
     if (nextType == NodeType::Snake && newHead != snakeBody_.back()) return false;
 
+    hash_ ^= keys_->head(head) ^ keys_->tail(snakeBody_.back()) ^ keys_->direction(direction_);
     if (nextType == NodeType::Food) {
         snakeBody_.push_front(newHead);
         grid_[newHead.y][newHead.x].type = NodeType::Snake;
+        hash_ ^= keys_->body(newHead);
         spawnFood();
     } else {
         sf::Vector2i tail = snakeBody_.back();
@@ -68,7 +87,10 @@ bool SnakeGame::step(sf::Vector2i direction) {
         snakeBody_.pop_back();
         snakeBody_.push_front(newHead);
         grid_[newHead.y][newHead.x].type = NodeType::Snake;
+        hash_ ^= keys_->body(tail) ^ keys_->body(newHead);
     }
+    direction_ = direction;
+    hash_ ^= keys_->head(newHead) ^ keys_->tail(snakeBody_.back()) ^ keys_->direction(direction_);
     return true;
 }
 
@@ -1,15 +1,18 @@
 #pragma once
 #include <vector>
 #include <deque>
+#include <random>
 #include <SFML/System.hpp>
 #include "Node.h"
 #include "Config.h"
+#include "Zobrist.h"
 
 class SnakeGame {
 public:
-    SnakeGame();
+    SnakeGame(int rows = Config::GRID_ROWS, int cols = Config::GRID_COLS);
     
     void reset();
+    void seed(unsigned int value) { rng_.seed(value); }
     bool step(sf::Vector2i direction);
     void spawnFood();
     sf::Vector2i findBestMoveBFS() const;
@@ -18,12 +21,25 @@ public:
     // Getters
     const std::vector<std::vector<Node>>& getGrid() const { return grid_; }
     const std::deque<sf::Vector2i>& getSnakeBody() const { return snakeBody_; }
-    sf::Vector2i getFoodPos() const;
+    sf::Vector2i getFoodPos() const { return foodPos_; }
     int getScore() const { return (int)snakeBody_.size(); }
+    int getRows() const { return rows_; }
+    int getCols() const { return cols_; }
+    sf::Vector2i getDirection() const { return direction_; } // of the last step, {1, 0} after reset
+
+    // Zobrist hash of (body, head, tail, food, direction), updated incrementally by step()
+    uint64_t getHash() const { return hash_; }
+    uint64_t getBoardHash() const { return hash_ ^ keys_->direction(direction_); } // without the heading
+    uint64_t computeHash() const; // from scratch, for verification
 
 private:
-    int rows_ = Config::GRID_ROWS;
-    int cols_ = Config::GRID_COLS;
+    int rows_;
+    int cols_;
     std::vector<std::vector<Node>> grid_;
     std::deque<sf::Vector2i> snakeBody_;
+    sf::Vector2i foodPos_ = {-1, -1};
+    sf::Vector2i direction_ = {1, 0};
+    const ZobristKeys* keys_;
+    uint64_t hash_ = 0;
+    std::mt19937 rng_;
 };
@@ -0,0 +1,30 @@
+#include "StateCache.h"
+#include "AiAgent.h"
+#include "Teacher.h"
+
+StateCache::StateCache(size_t capacity) : enabled_(capacity > 0), features_(capacity), moves_(capacity) {}
+
+std::vector<double> StateCache::features(const SnakeGame& game, sf::Vector2i direction) {
+    const auto& body = game.getSnakeBody();
+    // The hash covers the game's own heading; anything else has to be computed
+    if (!enabled_ || direction != game.getDirection()) {
+        return AiAgent::getState(game.getGrid(), body.front(), body.back(), game.getFoodPos(), direction);
+    }
+
+    std::vector<double> state;
+    if (features_.get(game.getHash(), state)) return state;
+    state = AiAgent::getState(game.getGrid(), body.front(), body.back(), game.getFoodPos(), direction);
+    features_.put(game.getHash(), state);
+    return state;
+}
+
+sf::Vector2i StateCache::teacherMove(const SnakeGame& game, const HamiltonianSolver& expert) {
+    if (!enabled_) return ::teacherMove(game, expert);
+
+    // The teacher ignores the heading, so positions reached from any side share an entry
+    sf::Vector2i move;
+    if (moves_.get(game.getBoardHash(), move)) return move;
+    move = ::teacherMove(game, expert);
+    moves_.put(game.getBoardHash(), move);
+    return move;
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <SFML/System.hpp>
+#include "SnakeGame.h"
+#include "HamiltonianSolver.h"
+#include "ShardedLruCache.h"
+
+/**
+ * @brief Memoises the expensive per-position work, keyed by SnakeGame::getHash():
+ * the feature vector (ray casts and three flood fills) and the teacher move
+ * (two BFS passes, then the Hamiltonian expert). Snakes chasing their tail revisit
+ * the same positions constantly, so most of these become a hash probe.
+ * Safe to share between threads. A capacity of 0 disables caching.
+ */
+class StateCache {
+public:
+    explicit StateCache(size_t capacity);
+
+    // AiAgent::getState for the game's current position, heading `direction`
+    std::vector<double> features(const SnakeGame& game, sf::Vector2i direction);
+    // teacherMove() for the game's current position
+    sf::Vector2i teacherMove(const SnakeGame& game, const HamiltonianSolver& expert);
+
+    uint64_t hits() const { return features_.hits() + moves_.hits(); }
+    uint64_t misses() const { return features_.misses() + moves_.misses(); }
+
+private:
+    bool enabled_;
+    ShardedLruCache<std::vector<double>> features_;
+    ShardedLruCache<sf::Vector2i> moves_;
+};
@@ -0,0 +1,14 @@
+#pragma once
+#include <SFML/System.hpp>
+#include "SnakeGame.h"
+#include "HamiltonianSolver.h"
+
+// Expert move used for demonstrations: the BFS path to the food when it is safe,
+// otherwise the Hamiltonian-cycle expert. Returns {0, 0} if every move is fatal.
+inline sf::Vector2i teacherMove(const SnakeGame& game, const HamiltonianSolver& expert) {
+    sf::Vector2i moveDir = game.findBestMoveBFS();
+    if (moveDir == sf::Vector2i(0, 0)) {
+        moveDir = expert.findMove(game);
+    }
+    return moveDir;
+}
@@ -0,0 +1,268 @@
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace {
+    thread_local ThreadPool* currentPool = nullptr;
+    thread_local int currentWorker = -1;
+
+    struct SharedSettings {
+        std::mutex mutex;
+        int threads = 0;
+        bool pin = false;
+    };
+    SharedSettings& sharedSettings() {
+        static SharedSettings settings;
+        return settings;
+    }
+
+    // "0-3,8,10-11" -> {0, 1, 2, 3, 8, 10, 11}
+    std::vector<int> parseCpuList(const std::string& text) {
+        std::vector<int> cpus;
+        std::istringstream iss(text);
+        std::string item;
+        while (std::getline(iss, item, ',')) {
+            char* rest = nullptr;
+            const long lo = std::strtol(item.c_str(), &rest, 10);
+            if (rest == item.c_str()) continue;
+            const long hi = *rest == '-' ? std::strtol(rest + 1, nullptr, 10) : lo;
+            for (long c = lo; c <= hi; ++c) cpus.push_back((int)c);
+        }
+        return cpus;
+    }
+
+    std::vector<int> allowedCpus() {
+        std::vector<int> cpus;
+#ifdef __linux__
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+            for (int c = 0; c < CPU_SETSIZE; ++c) {
+                if (CPU_ISSET(c, &set)) cpus.push_back(c);
+            }
+        }
+#endif
+        if (cpus.empty()) {
+            for (unsigned c = 0; c < std::max(1u, std::thread::hardware_concurrency()); ++c) cpus.push_back((int)c);
+        }
+        return cpus;
+    }
+
+    // CPU -> NUMA node from /sys; everything is node 0 when the information is missing
+    std::map<int, int> cpuNodes() {
+        std::map<int, int> nodes;
+        for (int node = 0; node < 1024; ++node) {
+            std::ifstream ifs("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+            if (!ifs.is_open()) {
+                if (node > 0) break;
+                continue;
+            }
+            std::string list;
+            std::getline(ifs, list);
+            for (int cpu : parseCpuList(list)) nodes[cpu] = node;
+        }
+        return nodes;
+    }
+
+    // Whole CPUs granted by the cgroup quota, 0 when unlimited or unknown
+    int cgroupCpuLimit() {
+        double quota = -1.0, period = 0.0;
+        std::ifstream v2("/sys/fs/cgroup/cpu.max");
+        if (v2.is_open()) {
+            std::string max;
+            v2 >> max >> period;
+            if (max != "max") quota = std::strtod(max.c_str(), nullptr);
+        } else {
+            std::ifstream q("/sys/fs/cgroup/cpu/cpu.cfs_quota_us"), p("/sys/fs/cgroup/cpu/cpu.cfs_period_us");
+            if (q.is_open() && p.is_open()) q >> quota, p >> period;
+        }
+        if (quota <= 0.0 || period <= 0.0) return 0;
+        return std::max(1, (int)std::ceil(quota / period));
+    }
+
+    void pinCurrentThread(int cpu) {
+#ifdef __linux__
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+        (void)cpu;
+#endif
+    }
+}
+
+int ThreadPool::availableCpus() {
+    const int allowed = (int)allowedCpus().size();
+    const int quota = cgroupCpuLimit();
+    return std::max(1, quota > 0 ? std::min(allowed, quota) : allowed);
+}
+
+void ThreadPool::configureShared(int threads, bool pin) {
+    SharedSettings& settings = sharedSettings();
+    std::lock_guard<std::mutex> lock(settings.mutex);
+    settings.threads = threads;
+    settings.pin = pin;
+}
+
+ThreadPool& ThreadPool::shared() {
+    static ThreadPool pool = [] {
+        SharedSettings& settings = sharedSettings();
+        std::lock_guard<std::mutex> lock(settings.mutex);
+        return ThreadPool(settings.threads > 0 ? settings.threads - 1 : -1, settings.pin);
+    }();
+    return pool;
+}
+
+ThreadPool::ThreadPool(int workers, bool pin) {
+    if (workers < 0) workers = availableCpus() - 1;
+
+    // Hand CPUs out node by node so consecutive workers share a node
+    const std::map<int, int> nodes = cpuNodes();
+    std::vector<int> cpus = allowedCpus();
+    auto nodeOf = [&](int cpu) { auto it = nodes.find(cpu); return it == nodes.end() ? 0 : it->second; };
+    std::stable_sort(cpus.begin(), cpus.end(), [&](int a, int b) { return nodeOf(a) < nodeOf(b); });
+
+    for (int i = 0; i < workers; ++i) {
+        auto worker = std::make_unique<Worker>();
+        // cpus[0] is left for the calling thread when there is room
+        const int cpu = cpus[(i + (cpus.size() > (size_t)workers ? 1 : 0)) % cpus.size()];
+        worker->cpu = pin ? cpu : -1;
+        worker->node = nodeOf(cpu);
+        workers_.push_back(std::move(worker));
+    }
+    for (int i = 0; i < workers; ++i) {
+        std::vector<int>& victims = workers_[i]->victims;
+        for (int k = 1; k < workers; ++k) victims.push_back((i + k) % workers);
+        std::stable_partition(victims.begin(), victims.end(), [&](int v) { return workers_[v]->node == workers_[i]->node; });
+    }
+    for (int i = 0; i < workers; ++i) threads_.emplace_back(&ThreadPool::workerLoop, this, i);
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+        stop_ = true;
+    }
+    wake_.notify_all();
+    for (auto& t : threads_) t.join();
+}
+
+void ThreadPool::submit(Task task) {
+    if (workers_.empty()) {
+        task();
+        return;
+    }
+    // Workers push onto their own deque; other threads spread tasks round-robin
+    const int target = (currentPool == this && currentWorker >= 0)
+        ? currentWorker
+        : (int)(nextQueue_.fetch_add(1, std::memory_order_relaxed) % workers_.size());
+    {
+        std::lock_guard<std::mutex> lock(workers_[target]->mutex);
+        workers_[target]->tasks.push_back(std::move(task));
+    }
+    queued_.fetch_add(1);
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+    }
+    wake_.notify_one();
+}
+
+void ThreadPool::parallelFor(size_t begin, size_t end, const std::function<void(size_t, size_t)>& body, size_t grain) {
+    if (begin >= end) return;
+    const size_t count = end - begin;
+    grain = std::max<size_t>(1, grain);
+    // A few chunks per thread so stealing can even out uneven chunks
+    const size_t chunks = std::min((count + grain - 1) / grain, (size_t)concurrency() * 4);
+    if (chunks <= 1 || workers_.empty()) {
+        body(begin, end);
+        return;
+    }
+
+    std::atomic<size_t> remaining{chunks};
+    auto chunkRange = [&](size_t c, size_t& lo, size_t& hi) {
+        lo = begin + count * c / chunks;
+        hi = begin + count * (c + 1) / chunks;
+    };
+    for (size_t c = 1; c < chunks; ++c) {
+        submit([&, c] {
+            size_t lo, hi;
+            chunkRange(c, lo, hi);
+            body(lo, hi);
+            remaining.fetch_sub(1, std::memory_order_release);
+        });
+    }
+    size_t lo, hi;
+    chunkRange(0, lo, hi);
+    body(lo, hi);
+    remaining.fetch_sub(1, std::memory_order_release);
+
+    // Help out until every chunk is done
+    const int self = currentPool == this ? currentWorker : -1;
+    while (remaining.load(std::memory_order_acquire) > 0) {
+        if (!runOne(self)) std::this_thread::yield();
+    }
+}
+
+void ThreadPool::workerLoop(int index) {
+    currentPool = this;
+    currentWorker = index;
+    if (workers_[index]->cpu >= 0) pinCurrentThread(workers_[index]->cpu);
+
+    while (true) {
+        if (runOne(index)) continue;
+        std::unique_lock<std::mutex> lock(sleepMutex_);
+        wake_.wait(lock, [&] { return stop_ || queued_.load() > 0; });
+        if (stop_ && queued_.load() == 0) return;
+    }
+}
+
+bool ThreadPool::runOne(int self) {
+    Task task;
+    if (!popOwn(self, task) && !steal(self, task)) return false;
+    queued_.fetch_sub(1);
+    task();
+    return true;
+}
+
+bool ThreadPool::popOwn(int self, Task& out) {
+    if (self < 0) return false;
+    Worker& w = *workers_[self];
+    std::lock_guard<std::mutex> lock(w.mutex);
+    if (w.tasks.empty()) return false;
+    out = std::move(w.tasks.back());
+    w.tasks.pop_back();
+    return true;
+}
+
+bool ThreadPool::steal(int self, Task& out) {
+    auto tryTake = [&](int victim) {
+        Worker& w = *workers_[victim];
+        std::lock_guard<std::mutex> lock(w.mutex);
+        if (w.tasks.empty()) return false;
+        out = std::move(w.tasks.front());
+        w.tasks.pop_front();
+        return true;
+    };
+    if (self >= 0) {
+        for (int victim : workers_[self]->victims) {
+            if (tryTake(victim)) return true;
+        }
+        return false;
+    }
+    const int n = (int)workers_.size();
+    const int start = (int)(nextQueue_.load(std::memory_order_relaxed) % std::max(1, n));
+    for (int k = 0; k < n; ++k) {
+        if (tryTake((start + k) % n)) return true;
+    }
+    return false;
+}
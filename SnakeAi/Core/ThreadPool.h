@@ -0,0 +1,75 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Persistent work-stealing thread pool shared by the parallel paths
+ * (batched training, evaluation games, feature extraction).
+ *
+ * Every worker owns a task deque: it pops its own newest task and, when empty,
+ * steals the oldest task of another worker, trying workers on its own NUMA node
+ * first. Workers can be pinned to CPUs; CPUs are handed out node by node so
+ * neighbouring workers share a node. The default size comes from
+ * availableCpus(), which honours the container's cgroup CPU quota.
+ *
+ * parallelFor() blocks, and the calling thread runs chunks too. Calling it from
+ * inside a task is fine: a waiting worker keeps executing other tasks.
+ */
+class ThreadPool {
+public:
+    using Task = std::function<void()>;
+
+    // workers < 0: availableCpus() - 1, since the caller of parallelFor() also works
+    explicit ThreadPool(int workers = -1, bool pin = false);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    int workers() const { return (int)workers_.size(); }
+    int concurrency() const { return workers() + 1; } // workers plus the calling thread
+
+    void submit(Task task);
+
+    // Calls body(lo, hi) over [begin, end) in chunks of at least `grain` items,
+    // and returns once every chunk has run
+    void parallelFor(size_t begin, size_t end, const std::function<void(size_t, size_t)>& body, size_t grain = 1);
+
+    // CPUs this process may use: the affinity mask, capped by the cgroup quota
+    // (cgroup v2 cpu.max or v1 cpu.cfs_quota_us / cpu.cfs_period_us)
+    static int availableCpus();
+
+    // Process-wide pool, created on first use. configureShared() only has an
+    // effect before that; threads <= 0 means availableCpus().
+    static ThreadPool& shared();
+    static void configureShared(int threads, bool pin);
+
+private:
+    struct Worker {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+        int cpu = -1;
+        int node = 0;
+        std::vector<int> victims; // steal order: same node first
+    };
+
+    void workerLoop(int index);
+    bool runOne(int self); // self < 0: a thread outside the pool
+    bool popOwn(int self, Task& out);
+    bool steal(int self, Task& out);
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::vector<std::thread> threads_;
+    std::atomic<int> queued_{0};
+    std::atomic<unsigned> nextQueue_{0};
+    std::mutex sleepMutex_;
+    std::condition_variable wake_;
+    bool stop_ = false;
+};
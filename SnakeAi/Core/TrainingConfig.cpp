@@ -0,0 +1,170 @@
+#include "TrainingConfig.h"
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace {
+    std::string trim(const std::string& s) {
+        const size_t b = s.find_first_not_of(" \t\r\n");
+        if (b == std::string::npos) return "";
+        const size_t e = s.find_last_not_of(" \t\r\n");
+        return s.substr(b, e - b + 1);
+    }
+
+    template <typename T>
+    bool parseNumber(const std::string& text, T& out) {
+        std::istringstream iss(text);
+        T value;
+        if (!(iss >> value) || !(iss >> std::ws).eof()) return false;
+        out = value;
+        return true;
+    }
+}
+
+bool TrainingConfig::loadFromFile(const std::string& filename) {
+    std::ifstream ifs(filename);
+    if (!ifs.is_open()) {
+        std::cerr << "Error: Could not open config " << filename << std::endl;
+        return false;
+    }
+
+    bool ok = true;
+    std::string line;
+    int lineNo = 0;
+    while (std::getline(ifs, line)) {
+        lineNo++;
+        if (trim(line.substr(0, line.find('#'))).empty()) continue;
+        if (!setFromLine(line)) {
+            std::cerr << filename << ":" << lineNo << ": invalid setting '" << trim(line) << "'" << std::endl;
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+bool TrainingConfig::set(const std::string& key, const std::string& value) {
+    if (key == "topology")           return parseTopology(value, layers);
+    if (key == "features")           return parseFeatureSet(value, features);
+    if (key == "board_rows")         return parseNumber(value, boardRows) && boardRows >= 2;
+    if (key == "board_cols")         return parseNumber(value, boardCols) && boardCols >= 2;
+    if (key == "learning_rate")      return parseNumber(value, learningRate);
+    if (key == "td_error_clip")      return parseNumber(value, tdErrorClip) && tdErrorClip >= 0.0;
+    if (key == "gamma")              return parseNumber(value, gamma);
+    if (key == "epsilon_decay")      return parseNumber(value, epsilonDecay);
+    if (key == "min_epsilon")        return parseNumber(value, minEpsilon);
+    if (key == "schedule")           return parseScheduleMode(value, schedule);
+    if (key == "schedule_window")    return parseNumber(value, scheduleWindow) && scheduleWindow > 0;
+    if (key == "schedule_eval_games") return parseNumber(value, scheduleEvalGames) && scheduleEvalGames > 0;
+    if (key == "schedule_patience")  return parseNumber(value, schedulePatience) && schedulePatience > 0;
+    if (key == "schedule_min_gain")  return parseNumber(value, scheduleMinGain) && scheduleMinGain >= 0.0;
+    if (key == "epsilon_boost")      return parseNumber(value, epsilonBoost) && epsilonBoost >= 0.0 && epsilonBoost <= 1.0;
+    if (key == "lr_decay")           return parseNumber(value, lrDecay) && lrDecay > 0.0 && lrDecay <= 1.0;
+    if (key == "min_learning_rate")  return parseNumber(value, minLearningRate) && minLearningRate >= 0.0;
+    if (key == "curriculum_start")   return parseNumber(value, curriculumStart) && (curriculumStart == 0 || curriculumStart >= 2);
+    if (key == "curriculum_step")    return parseNumber(value, curriculumStep) && curriculumStep > 0;
+    if (key == "curriculum_promote") return parseNumber(value, curriculumPromote) && curriculumPromote > 0.0;
+    if (key == "schedule_file")      { scheduleFile = value; return true; }
+    if (key == "batch_size")         return parseNumber(value, batchSize) && batchSize > 0;
+    if (key == "train_slices")       return parseNumber(value, trainSlices) && trainSlices >= 0;
+    if (key == "replay_memory_size") return parseNumber(value, replayMemorySize) && replayMemorySize > 0;
+    if (key == "replay_spill_file")  { replaySpillFile = value; return true; }
+    if (key == "replay_hot_size")    return parseNumber(value, replayHotSize) && replayHotSize > 0;
+    if (key == "checkpoint_keep")    return parseNumber(value, checkpointKeep) && checkpointKeep >= 0;
+    if (key == "state_cache_size")   return parseNumber(value, stateCacheSize) && stateCacheSize >= 0;
+    if (key == "log_interval")       return parseNumber(value, logInterval) && logInterval > 0;
+    if (key == "metrics_file")       { metricsFile = value; return true; }
+    if (key == "metrics_interval")   return parseNumber(value, metricsInterval) && metricsInterval > 0.0;
+    if (key == "threads")            return parseNumber(value, threads) && threads >= 0;
+    if (key == "pin_threads")        return parseNumber(value, pinThreads);
+    if (key == "reward_food")        return parseNumber(value, rewardFood);
+    if (key == "reward_death")       return parseNumber(value, rewardDeath);
+    if (key == "reward_step")        return parseNumber(value, rewardStep);
+    if (key == "reward_closer")      return parseNumber(value, rewardCloser);
+    if (key == "reward_away")        return parseNumber(value, rewardAway);
+    return false;
+}
+
+bool TrainingConfig::setFromLine(const std::string& line) {
+    const std::string content = trim(line.substr(0, line.find('#')));
+    const size_t eq = content.find('=');
+    if (eq == std::string::npos) return false;
+    return set(trim(content.substr(0, eq)), trim(content.substr(eq + 1)));
+}
+
+void TrainingConfig::write(std::ostream& os) const {
+    writeModel(os);
+    writeRuntime(os);
+}
+
+void TrainingConfig::writeModel(std::ostream& os) const {
+    os << "topology = " << topologyString() << "\n"
+       << "features = " << featureSetName(features) << "\n"
+       << "board_rows = " << boardRows << "\n"
+       << "board_cols = " << boardCols << "\n"
+       << "learning_rate = " << learningRate << "\n"
+       << "td_error_clip = " << tdErrorClip << "\n"
+       << "gamma = " << gamma << "\n"
+       << "epsilon_decay = " << epsilonDecay << "\n"
+       << "min_epsilon = " << minEpsilon << "\n"
+       << "batch_size = " << batchSize << "\n"
+       << "reward_food = " << rewardFood << "\n"
+       << "reward_death = " << rewardDeath << "\n"
+       << "reward_step = " << rewardStep << "\n"
+       << "reward_closer = " << rewardCloser << "\n"
+       << "reward_away = " << rewardAway << "\n";
+}
+
+void TrainingConfig::writeRuntime(std::ostream& os) const {
+    os << "schedule = " << scheduleModeName(schedule) << "\n"
+       << "schedule_window = " << scheduleWindow << "\n"
+       << "schedule_eval_games = " << scheduleEvalGames << "\n"
+       << "schedule_patience = " << schedulePatience << "\n"
+       << "schedule_min_gain = " << scheduleMinGain << "\n"
+       << "epsilon_boost = " << epsilonBoost << "\n"
+       << "lr_decay = " << lrDecay << "\n"
+       << "min_learning_rate = " << minLearningRate << "\n"
+       << "curriculum_start = " << curriculumStart << "\n"
+       << "curriculum_step = " << curriculumStep << "\n"
+       << "curriculum_promote = " << curriculumPromote << "\n"
+       << "schedule_file = " << scheduleFile << "\n"
+       << "train_slices = " << trainSlices << "\n"
+       << "replay_memory_size = " << replayMemorySize << "\n"
+       << "replay_spill_file = " << replaySpillFile << "\n"
+       << "replay_hot_size = " << replayHotSize << "\n"
+       << "checkpoint_keep = " << checkpointKeep << "\n"
+       << "state_cache_size = " << stateCacheSize << "\n"
+       << "log_interval = " << logInterval << "\n"
+       << "metrics_file = " << metricsFile << "\n"
+       << "metrics_interval = " << metricsInterval << "\n"
+       << "threads = " << threads << "\n"
+       << "pin_threads = " << pinThreads << "\n";
+}
+
+// Format: "34,128:relu,64:fasttanh,3:linear" (input size first, no activation)
+std::string TrainingConfig::topologyString() const {
+    std::string out;
+    for (size_t i = 0; i < layers.size(); ++i) {
+        if (i > 0) out += ",";
+        out += std::to_string(layers[i].size);
+        if (i > 0) out += std::string(":") + activationName(layers[i].activation);
+    }
+    return out;
+}
+
+bool TrainingConfig::parseTopology(const std::string& text, std::vector<LayerSpec>& out) {
+    std::vector<LayerSpec> parsed;
+    std::istringstream iss(text);
+    std::string item;
+    while (std::getline(iss, item, ',')) {
+        item = trim(item);
+        const size_t colon = item.find(':');
+        LayerSpec spec = {0, Activation::Tanh};
+        if (!parseNumber(trim(item.substr(0, colon)), spec.size) || spec.size <= 0) return false;
+        if (colon != std::string::npos && !parseActivation(trim(item.substr(colon + 1)), spec.activation)) return false;
+        parsed.push_back(spec);
+    }
+    if (parsed.size() < 2) return false;
+    parsed[0].activation = Activation::Linear;
+    out = parsed;
+    return true;
+}
@@ -0,0 +1,96 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <ostream>
+#include "Config.h"
+#include "SimpleNN.h"
+
+// Network inputs: the 34 ray/flood-fill features (AiAgent::getState), or the
+// egocentric 9x9 window (WindowFeatures.h), whose cost does not grow with the board.
+enum class FeatureSet { Rays, Window };
+
+inline const char* featureSetName(FeatureSet f) { return f == FeatureSet::Window ? "window" : "rays"; }
+
+inline bool parseFeatureSet(const std::string& name, FeatureSet& out) {
+    if (name == "rays")        out = FeatureSet::Rays;
+    else if (name == "window") out = FeatureSet::Window;
+    else return false;
+    return true;
+}
+
+// Fixed: epsilon decays by epsilonDecay every game. Adaptive: TrainingSchedule
+// decays it only while the rolling score improves and adjusts the learning rate.
+enum class ScheduleMode { Fixed, Adaptive };
+
+inline const char* scheduleModeName(ScheduleMode m) { return m == ScheduleMode::Adaptive ? "adaptive" : "fixed"; }
+
+inline bool parseScheduleMode(const std::string& name, ScheduleMode& out) {
+    if (name == "fixed")         out = ScheduleMode::Fixed;
+    else if (name == "adaptive") out = ScheduleMode::Adaptive;
+    else return false;
+    return true;
+}
+
+struct LayerSpec {
+    int size;
+    Activation activation;
+};
+
+/**
+ * @brief Runtime-tunable training settings. Defaults come from Config; any of
+ * them can be overridden from a "key = value" file without recompiling.
+ * Checkpoint headers carry only the settings that define the model; runtime
+ * settings (threads, files, logging, schedule) stay with the process that set them.
+ */
+struct TrainingConfig {
+    // Input layer first; its activation is ignored
+    std::vector<LayerSpec> layers = {{34, Activation::Linear}, {128, Activation::Tanh}, {3, Activation::Linear}};
+    FeatureSet features = FeatureSet::Rays;
+    int boardRows = Config::GRID_ROWS; // board used by the headless trainer
+    int boardCols = Config::GRID_COLS;
+    double learningRate = 0.01;
+    double tdErrorClip = 0.0; // Huber-style clip of the TD error, 0 disables
+    double gamma = Config::GAMMA;
+    double epsilonDecay = Config::EPSILON_DECAY;
+    double minEpsilon = Config::MIN_EPSILON;
+    ScheduleMode schedule = ScheduleMode::Fixed;
+    int scheduleWindow = 50; // training games between two schedule decisions
+    int scheduleEvalGames = 20; // greedy games on the schedule's board that score each window
+    int schedulePatience = 3; // windows without improvement before a plateau
+    double scheduleMinGain = 0.05; // relative gain of the window mean that counts as improvement
+    double epsilonBoost = 0.1; // epsilon raised back to this on a plateau or a larger board
+    double lrDecay = 0.5; // learning rate factor on a plateau
+    double minLearningRate = 0.0005;
+    int curriculumStart = 0; // first board side length, 0 trains on board_rows x board_cols from the start
+    int curriculumStep = 5; // board side growth per promotion
+    double curriculumPromote = 0.25; // greedy mean score, as a fraction of the board's cells, that promotes
+    std::string scheduleFile; // per-worker schedule state (epsilon, learning rate, board); empty keeps it in memory
+    int batchSize = Config::BATCH_SIZE;
+    int trainSlices = 1; // batch slices whose gradients are computed in parallel; 1 = per-sample updates, 0 = one per pool thread
+    int replayMemorySize = Config::REPLAY_MEMORY_SIZE;
+    std::string replaySpillFile; // spill file for transitions beyond the RAM tier; empty keeps the replay memory in RAM
+    int replayHotSize = 1 << 16; // transitions kept in RAM when spilling
+    int checkpointKeep = 3; // numbered checkpoints kept next to the model file
+    int stateCacheSize = 1 << 15; // cached positions (features and teacher moves), 0 disables
+    int logInterval = 100; // attempts per summary line
+    std::string metricsFile; // Prometheus text file, rewritten every metricsInterval seconds; empty disables
+    double metricsInterval = 10.0;
+    int threads = 0; // shared thread pool size, 0 = CPUs allowed by the affinity mask and cgroup quota
+    bool pinThreads = false; // pin pool workers to CPUs
+
+    double rewardFood = Config::REWARD_FOOD;
+    double rewardDeath = Config::REWARD_DEATH;
+    double rewardStep = Config::REWARD_STEP;
+    double rewardCloser = Config::REWARD_CLOSER;
+    double rewardAway = Config::REWARD_AWAY;
+
+    bool loadFromFile(const std::string& filename);
+    bool set(const std::string& key, const std::string& value);
+    bool setFromLine(const std::string& line); // "key = value", '#' starts a comment
+    void write(std::ostream& os) const; // every setting, as loadFromFile() reads them
+    void writeModel(std::ostream& os) const; // what defines and trains the network (checkpoint headers)
+    void writeRuntime(std::ostream& os) const; // this process's resources, files and schedule
+
+    std::string topologyString() const;
+    static bool parseTopology(const std::string& text, std::vector<LayerSpec>& out);
+};
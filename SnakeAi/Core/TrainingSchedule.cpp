@@ -0,0 +1,116 @@
+#include "TrainingSchedule.h"
+#include "Checkpoint.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+TrainingSchedule::TrainingSchedule(const TrainingConfig& config) : config_(config) {
+    state_.learningRate = config_.learningRate;
+    state_.boardRows = config_.curriculumStart > 0 ? config_.curriculumStart : config_.boardRows;
+    state_.boardCols = config_.curriculumStart > 0 ? config_.curriculumStart : config_.boardCols;
+    clampBoard();
+}
+
+bool TrainingSchedule::endGame() {
+    state_.games++;
+    const bool adaptive = config_.schedule == ScheduleMode::Adaptive;
+    if ((!adaptive || improving_) && state_.epsilon > config_.minEpsilon) {
+        state_.epsilon = std::max(config_.minEpsilon, state_.epsilon * config_.epsilonDecay);
+    }
+    if (++windowGames_ < config_.scheduleWindow) return false;
+    windowGames_ = 0;
+    return true;
+}
+
+TrainingSchedule::Event TrainingSchedule::endWindow(double mean) {
+    const bool adaptive = config_.schedule == ScheduleMode::Adaptive;
+    lastMean_ = mean;
+
+    const bool improved = state_.bestMean < 0.0 || mean > state_.bestMean * (1.0 + config_.scheduleMinGain);
+    if (improved) {
+        state_.bestMean = mean;
+        state_.staleWindows = 0;
+    } else {
+        state_.staleWindows++;
+    }
+    const bool plateau = state_.staleWindows >= config_.schedulePatience;
+
+    if (promote()) {
+        // Scores on the larger board are not comparable with the old best
+        state_.bestMean = -1.0;
+        state_.staleWindows = 0;
+        improving_ = true;
+        if (adaptive) state_.epsilon = std::max(state_.epsilon, config_.epsilonBoost);
+        return Event::Promoted;
+    }
+    improving_ = improved; // hold exploration while the score is flat
+    if (!plateau) return Event::None;
+
+    // Plateau: measure gains from here on; adaptive mode also explores again and takes smaller steps
+    state_.bestMean = mean;
+    state_.staleWindows = 0;
+    improving_ = true;
+    if (!adaptive) return Event::None;
+    state_.epsilon = std::max(state_.epsilon, config_.epsilonBoost);
+    state_.learningRate = std::max(config_.minLearningRate, state_.learningRate * config_.lrDecay);
+    return Event::Plateau;
+}
+
+// A plateau does not promote: a network stuck below the target would only do worse on a larger board
+bool TrainingSchedule::promote() {
+    if (config_.curriculumStart <= 0) return false;
+    if (state_.boardRows >= config_.boardRows && state_.boardCols >= config_.boardCols) return false;
+    if (lastMean_ < config_.curriculumPromote * state_.boardRows * state_.boardCols) return false;
+    state_.boardRows += config_.curriculumStep;
+    state_.boardCols += config_.curriculumStep;
+    clampBoard();
+    return true;
+}
+
+void TrainingSchedule::clampBoard() {
+    const int minRows = config_.curriculumStart > 0 ? std::min(config_.curriculumStart, config_.boardRows) : config_.boardRows;
+    const int minCols = config_.curriculumStart > 0 ? std::min(config_.curriculumStart, config_.boardCols) : config_.boardCols;
+    state_.boardRows = std::clamp(state_.boardRows, minRows, config_.boardRows);
+    state_.boardCols = std::clamp(state_.boardCols, minCols, config_.boardCols);
+}
+
+bool TrainingSchedule::load(const std::string& path) {
+    std::ifstream ifs(path);
+    if (!ifs.is_open()) return false;
+
+    State loaded;
+    int found = 0;
+    std::string key, eq;
+    while (ifs >> key >> eq) {
+        if (eq != "=") break;
+        if (key == "epsilon" && ifs >> loaded.epsilon) found++;
+        else if (key == "learning_rate" && ifs >> loaded.learningRate) found++;
+        else if (key == "board_rows" && ifs >> loaded.boardRows) found++;
+        else if (key == "board_cols" && ifs >> loaded.boardCols) found++;
+        else if (key == "best_mean" && ifs >> loaded.bestMean) found++;
+        else if (key == "stale_windows" && ifs >> loaded.staleWindows) found++;
+        else if (key == "games" && ifs >> loaded.games) found++;
+        else break;
+    }
+    if (found != 7 || !ifs.eof() || loaded.epsilon < 0.0 || loaded.epsilon > 1.0 || loaded.learningRate <= 0.0) {
+        std::cerr << "Error: Schedule state " << path << " is invalid. Starting a new schedule." << std::endl;
+        return false;
+    }
+    state_ = loaded;
+    clampBoard(); // the configured board may have changed since the state was saved
+    return true;
+}
+
+bool TrainingSchedule::save(const std::string& path) const {
+    std::ostringstream os;
+    os.precision(17);
+    os << "epsilon = " << state_.epsilon << "\n"
+       << "learning_rate = " << state_.learningRate << "\n"
+       << "board_rows = " << state_.boardRows << "\n"
+       << "board_cols = " << state_.boardCols << "\n"
+       << "best_mean = " << state_.bestMean << "\n"
+       << "stale_windows = " << state_.staleWindows << "\n"
+       << "games = " << state_.games << "\n";
+    return writeFileAtomically(path, os.str(), false);
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include <string>
+#include "TrainingConfig.h"
+
+/**
+ * @brief Per-worker exploration, learning-rate and board-size schedule. After
+ * every scheduleWindow training games it is fed the mean score of greedy games
+ * the network played on its own on the schedule's board; training games follow
+ * the teacher, so their scores say nothing about the network.
+ *
+ * In adaptive mode epsilon only decays while that mean keeps improving.
+ * After schedulePatience windows without improvement, epsilon is raised back to
+ * epsilonBoost and the learning rate is multiplied by lrDecay. With a curriculum,
+ * training starts on a small board that grows by curriculumStep, up to the
+ * configured board, once the mean reaches curriculumPromote of its cells.
+ *
+ * The state belongs to one worker and is saved to its own file. The shared
+ * checkpoint still records the epsilon of whichever worker wrote it; trainers
+ * re-apply their own schedule after every load, so that value is only used to
+ * seed a worker that has no saved state yet (see adoptEpsilon).
+ */
+class TrainingSchedule {
+public:
+    enum class Event { None, Plateau, Promoted };
+
+    struct State {
+        double epsilon = 1.0;
+        double learningRate = 0.01;
+        int boardRows = 0;
+        int boardCols = 0;
+        double bestMean = -1.0; // best window mean on the current board, -1 before the first window
+        int staleWindows = 0;   // windows since bestMean last improved
+        long long games = 0;
+    };
+
+    explicit TrainingSchedule(const TrainingConfig& config);
+
+    // Called once per finished training game; true when a window is complete and endWindow() is due
+    bool endGame();
+
+    // The network's greedy mean score on boardRows() x boardCols() for the window just completed;
+    // a non-None event means the schedule changed course
+    Event endWindow(double greedyMean);
+
+    // Fixed epsilon decay on a fixed board never looks at scores
+    bool needsEvaluation() const { return config_.schedule == ScheduleMode::Adaptive || config_.curriculumStart > 0; }
+
+    // Starting epsilon when there is no worker state yet (e.g. from the first checkpoint loaded)
+    void adoptEpsilon(double epsilon) { state_.epsilon = epsilon; }
+
+    bool load(const std::string& path); // false if missing or invalid; the state is then left as is
+    bool save(const std::string& path) const;
+
+    const State& state() const { return state_; }
+    double epsilon() const { return state_.epsilon; }
+    double learningRate() const { return state_.learningRate; }
+    int boardRows() const { return state_.boardRows; }
+    int boardCols() const { return state_.boardCols; }
+    double lastWindowMean() const { return lastMean_; }
+
+private:
+    bool promote();
+    void clampBoard();
+
+    TrainingConfig config_;
+    State state_;
+    int windowGames_ = 0;
+    double lastMean_ = 0.0;
+    bool improving_ = true; // epsilon decays only while improving (adaptive mode)
+};
@@ -0,0 +1,35 @@
+#pragma once
+#include <atomic>
+
+/**
+ * @brief Lock-free single-producer/single-consumer triple buffer.
+ * The producer fills back() and publish()es it; the consumer calls update()
+ * and reads front(). Neither side ever waits, and the consumer always gets
+ * the most recently published value (intermediate ones are dropped).
+ */
+template <typename T>
+class TripleBuffer {
+public:
+    // Producer side
+    T& back() { return buffers_[backIndex_]; }
+    void publish() {
+        backIndex_ = middle_.exchange(backIndex_ | DIRTY, std::memory_order_acq_rel) & INDEX_MASK;
+    }
+
+    // Consumer side; returns false if nothing new was published
+    bool update() {
+        if ((middle_.load(std::memory_order_acquire) & DIRTY) == 0) return false;
+        frontIndex_ = middle_.exchange(frontIndex_, std::memory_order_acq_rel) & INDEX_MASK;
+        return true;
+    }
+    const T& front() const { return buffers_[frontIndex_]; }
+
+private:
+    static const int DIRTY = 4;
+    static const int INDEX_MASK = 3;
+
+    T buffers_[3];
+    int backIndex_ = 0;
+    std::atomic<int> middle_{1};
+    int frontIndex_ = 2;
+};
@@ -0,0 +1,59 @@
+#include "WindowFeatures.h"
+#include <cmath>
+#include <cstdlib>
+
+void WindowObservation::toDense(std::vector<double>& out) const {
+    out.resize(INPUT_SIZE);
+    for (int i = 0; i < BITS; ++i) out[i] = (bits[i >> 6] >> (i & 63)) & 1 ? 1.0 : 0.0;
+    for (int i = 0; i < EXTRAS; ++i) out[BITS + i] = extras[i];
+}
+
+WindowObservation WindowObservation::fromDense(const std::vector<double>& dense) {
+    WindowObservation obs;
+    for (int i = 0; i < BITS; ++i) {
+        if (dense[i] > 0.5) obs.bits[i >> 6] |= uint64_t(1) << (i & 63);
+    }
+    for (int i = 0; i < EXTRAS; ++i) obs.extras[i] = dense[BITS + i];
+    return obs;
+}
+
+WindowObservation encodeWindow(const std::vector<std::vector<Node>>& grid, sf::Vector2i head, sf::Vector2i tail,
+                               sf::Vector2i food, sf::Vector2i direction, int length) {
+    WindowObservation obs;
+    const int rows = (int)grid.size();
+    const int cols = (int)grid[0].size();
+    const sf::Vector2i right = {-direction.y, direction.x};
+    const int R = WindowObservation::RADIUS;
+
+    for (int i = 0; i < WindowObservation::SIDE; ++i) {
+        for (int j = 0; j < WindowObservation::SIDE; ++j) {
+            const int forward = R - i;
+            const int side = j - R;
+            const sf::Vector2i p = head + direction * forward + right * side;
+            const int bit = i * WindowObservation::SIDE + j;
+
+            bool obstacle = false;
+            if (p.x < 0 || p.x >= cols || p.y < 0 || p.y >= rows) obstacle = true;
+            else if (p != head && p != tail && grid[p.y][p.x].type == NodeType::Snake) obstacle = true;
+            if (obstacle) obs.bits[bit >> 6] |= 1ull << (bit & 63);
+
+            const int foodBit = WindowObservation::CELLS + bit;
+            if (p == food) obs.bits[foodBit >> 6] |= 1ull << (foodBit & 63);
+        }
+    }
+
+    // Heading-relative direction to a target, L1-normalised so it does not depend on board size
+    auto relative = [&](sf::Vector2i target, double& forward, double& side) {
+        const sf::Vector2i d = target - head;
+        const int f = d.x * direction.x + d.y * direction.y;
+        const int s = d.x * right.x + d.y * right.y;
+        const int norm = std::abs(f) + std::abs(s);
+        forward = norm > 0 ? (double)f / norm : 0.0;
+        side = norm > 0 ? (double)s / norm : 0.0;
+    };
+    relative(food, obs.extras[0], obs.extras[1]);
+    relative(tail, obs.extras[2], obs.extras[3]);
+    obs.extras[4] = food.x < 0 ? 0.0 : 1.0 / (1.0 + std::abs(food.x - head.x) + std::abs(food.y - head.y));
+    obs.extras[5] = (double)length / (rows * cols);
+    return obs;
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <SFML/System.hpp>
+#include "Node.h"
+
+/**
+ * @brief Egocentric view of the board for large boards: a 9x9 patch around the
+ * head, rotated so the snake always faces up, as two bit planes (obstacles and
+ * food), plus a few scale-free summary values. Encoding reads 81 cells whatever
+ * the board size, and NeuralNetwork::feedForwardBits consumes the bit planes
+ * without expanding them.
+ *
+ * Dense layout (toDense): obstacle bits, food bits, then the extras.
+ */
+struct WindowObservation {
+    static const int SIDE = 9;
+    static const int RADIUS = SIDE / 2;
+    static const int CELLS = SIDE * SIDE;
+    static const int BITS = 2 * CELLS;
+    static const int EXTRAS = 6; // food forward/side, tail forward/side, food proximity, board fill
+    static const int INPUT_SIZE = BITS + EXTRAS;
+
+    uint64_t bits[(BITS + 63) / 64] = {};
+    double extras[EXTRAS] = {};
+
+    void toDense(std::vector<double>& out) const;
+    static WindowObservation fromDense(const std::vector<double>& dense); // inverse of toDense
+};
+
+// Window row 0 is the farthest row ahead of the head, column 0 the leftmost.
+WindowObservation encodeWindow(const std::vector<std::vector<Node>>& grid, sf::Vector2i head, sf::Vector2i tail,
+                               sf::Vector2i food, sf::Vector2i direction, int length);
@@ -0,0 +1,24 @@
+#include "Zobrist.h"
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+
+ZobristKeys::ZobristKeys(int rows, int cols) : cols_(cols) {
+    std::mt19937_64 rng(0x5A0B12157ull ^ ((uint64_t)rows << 32) ^ (uint64_t)cols);
+    const size_t cells = (size_t)rows * cols;
+    for (auto* table : {&body_, &head_, &tail_, &food_}) {
+        table->resize(cells);
+        for (auto& key : *table) key = rng();
+    }
+    for (auto& key : direction_) key = rng();
+}
+
+const ZobristKeys& ZobristKeys::forBoard(int rows, int cols) {
+    static std::mutex mutex;
+    static std::map<std::pair<int, int>, std::unique_ptr<ZobristKeys>> boards;
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& keys = boards[{rows, cols}];
+    if (!keys) keys = std::make_unique<ZobristKeys>(rows, cols);
+    return *keys;
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <SFML/System.hpp>
+
+/**
+ * @brief Random 64-bit keys for Zobrist hashing a snake position. A position's
+ * hash is the XOR of the keys of everything on the board, so a move only
+ * touches the few keys that changed. Keys are fixed per board size, so equal
+ * positions hash equally across games and threads.
+ */
+class ZobristKeys {
+public:
+    ZobristKeys(int rows, int cols);
+
+    // Shared, immutable keys for a board size
+    static const ZobristKeys& forBoard(int rows, int cols);
+
+    uint64_t body(sf::Vector2i p) const { return body_[index(p)]; }
+    uint64_t head(sf::Vector2i p) const { return head_[index(p)]; }
+    uint64_t tail(sf::Vector2i p) const { return tail_[index(p)]; }
+    uint64_t food(sf::Vector2i p) const { return p.x < 0 ? 0 : food_[index(p)]; }
+    uint64_t direction(sf::Vector2i d) const { return direction_[(d.x + 1) + (d.y + 1) * 3]; }
+
+private:
+    size_t index(sf::Vector2i p) const { return (size_t)p.y * cols_ + p.x; }
+
+    int cols_;
+    std::vector<uint64_t> body_;
+    std::vector<uint64_t> head_;
+    std::vector<uint64_t> tail_;
+    std::vector<uint64_t> food_;
+    uint64_t direction_[9];
+};
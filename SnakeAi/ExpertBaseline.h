@@ -0,0 +1,50 @@
+#pragma once
+#include "Core/SnakeGame.h"
+#include "Core/HamiltonianSolver.h"
+#include "Core/Config.h"
+#include <iostream>
+#include <chrono>
+
+/**
+ * @brief Plays full games with the Hamiltonian-cycle expert and reports score
+ * and simulation throughput. Used as a baseline for the learned policies.
+ */
+class ExpertBaseline {
+public:
+    explicit ExpertBaseline(int games = 100, int maxSteps = 1000000) : games_(games), maxSteps_(maxSteps) {}
+
+    void run() {
+        std::cout << "--- Hamiltonian Expert Baseline ---" << std::endl;
+        const int boardCells = Config::GRID_ROWS * Config::GRID_COLS;
+        long long totalSteps = 0;
+        long long totalScore = 0;
+        int wins = 0;
+
+        auto start = std::chrono::steady_clock::now();
+        for (int g = 0; g < games_; ++g) {
+            game_.reset();
+            int steps = 0;
+            while (steps < maxSteps_) {
+                sf::Vector2i move = expert_.findMove(game_);
+                if (move == sf::Vector2i(0, 0) || !game_.step(move)) break;
+                steps++;
+                if (game_.getFoodPos().x == -1) break; // board is full
+            }
+            totalSteps += steps;
+            totalScore += game_.getScore();
+            if (game_.getScore() >= expert_.cycleLength()) wins++;
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout << "Games: " << games_
+                  << " | Avg Score: " << (double)totalScore / games_ << " / " << boardCells
+                  << " | Boards Cleared: " << wins
+                  << " | Steps/sec: " << (seconds > 0 ? totalSteps / seconds : 0.0) << "\n";
+    }
+
+private:
+    SnakeGame game_;
+    HamiltonianSolver expert_;
+    int games_;
+    int maxSteps_;
+};
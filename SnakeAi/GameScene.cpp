@@ -2,8 +2,11 @@
 #include "EmbeddedAssets.h"
 #include <iostream>
 #include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
 
-GameScene::GameScene(const sf::Vector2u &windowSize)
+GameScene::GameScene(const sf::Vector2u &windowSize, int boardCount) : mesh_(Config::GRID_ROWS, Config::GRID_COLS)
 {
     const float winW = static_cast<float>(windowSize.x);
     const float winH = static_cast<float>(windowSize.y);
@@ -20,115 +23,269 @@ GameScene::GameScene(const sf::Vector2u &windowSize)
 
     const float statsX = offsetX_ + totalGridW + 10.f;
     const float statsY = offsetY_ + 10.f;
-    statsBg_.setSize({std::max(0.f, rightMargin_ - 20.f), std::max(0.f, totalGridH - 20.f)});
-    statsBg_.setPosition(statsX, statsY);
-    statsBg_.setFillColor(sf::Color(40, 40, 40));
 
-    statsTitle_.setFont(uiFont_); statsTitle_.setCharacterSize(20); statsTitle_.setString("AI Evaluation"); statsTitle_.setPosition(statsX + 8.f, statsY + 8.f);
+    // Frame, stats panel and grid all live in one vertex array
+    mesh_.addRect({0, 0}, {winW, offsetY_}, Config::COLOR_FRAME);
+    mesh_.addRect({0, winH - offsetY_}, {winW, offsetY_}, Config::COLOR_FRAME);
+    mesh_.addRect({0, 0}, {offsetX_, winH}, Config::COLOR_FRAME);
+    mesh_.addRect({winW - rightMargin_, 0}, {rightMargin_, winH}, Config::COLOR_FRAME);
+    mesh_.addRect({statsX, statsY}, {std::max(0.f, rightMargin_ - 20.f), std::max(0.f, totalGridH - 20.f)}, sf::Color(40, 40, 40));
+
+    boardCount = std::max(1, boardCount);
+    envs_.resize(boardCount);
+    if (boardCount == 1) {
+        boardIndex_.push_back(mesh_.addBoard({offsetX_, offsetY_}, cellSize_, Config::CELL_PADDING));
+        tiles_.push_back({offsetX_, offsetY_, totalGridW, totalGridH});
+    } else {
+        // Square-ish grid of tiles, each a small board with a score gauge underneath
+        const int side = (int)std::ceil(std::sqrt((double)boardCount));
+        const float tileW = totalGridW / side;
+        const float tileH = totalGridH / side;
+        const float gap = std::max(2.f, tileW * 0.04f);
+        const float barH = std::max(2.f, tileH * 0.05f);
+        const float tileCell = std::min((tileW - gap) / cols_, (tileH - gap - barH - 1.f) / rows_);
+        const float padding = tileCell >= 6.f ? Config::CELL_PADDING : 0.f;
+        for (int i = 0; i < boardCount; ++i) {
+            const sf::Vector2f origin = {offsetX_ + (i % side) * tileW + gap * 0.5f, offsetY_ + (i / side) * tileH + gap * 0.5f};
+            boardIndex_.push_back(mesh_.addBoard(origin, tileCell, padding));
+            scoreBar_.push_back(mesh_.addBar({origin.x, origin.y + tileCell * rows_ + 1.f}, {tileCell * cols_, barH}, sf::Color(40, 40, 40), Config::COLOR_SNAKE_BODY));
+            tiles_.push_back({origin.x, origin.y, tileCell * cols_, tileCell * rows_ + 1.f + barH});
+        }
+    }
+
+    statsTitle_.setFont(uiFont_); statsTitle_.setCharacterSize(20); statsTitle_.setPosition(statsX + 8.f, statsY + 8.f);
+    statsTitle_.setString(boardCount == 1 ? "AI Evaluation" : std::to_string(boardCount) + " Boards");
     lengthText_.setFont(uiFont_); lengthText_.setCharacterSize(16); lengthText_.setPosition(statsX + 8.f, statsY + 40.f);
     highScoreText_.setFont(uiFont_); highScoreText_.setCharacterSize(16); highScoreText_.setFillColor(sf::Color::Yellow); highScoreText_.setPosition(statsX + 8.f, statsY + 70.f);
     attemptText_.setFont(uiFont_); attemptText_.setCharacterSize(16); attemptText_.setFillColor(sf::Color::Cyan); attemptText_.setPosition(statsX + 8.f, statsY + 100.f);
+    speedText_.setFont(uiFont_); speedText_.setCharacterSize(16); speedText_.setFillColor(sf::Color(180, 180, 180)); speedText_.setPosition(statsX + 8.f, statsY + 130.f);
+    tileText_.setFont(uiFont_); tileText_.setCharacterSize(14); tileText_.setPosition(statsX + 8.f, statsY + 170.f);
 
     aiAgent_.load("model.txt");
-    aiAgent_.epsilon = 0.01; 
-    resetGame();
+    aiAgent_.epsilon = 0.01;
+
+    running_ = true;
+    simThread_ = std::thread(&GameScene::simLoop, this);
 }
 
-void GameScene::resetGame() { game_.reset(); direction_ = {1, 0}; moveInterval_ = Config::MOVE_INTERVAL; timeSinceLastMove_ = sf::Time::Zero; isGameOver_ = false; }
+GameScene::~GameScene() { stopSimulation(); }
+
+void GameScene::stopSimulation()
+{
+    running_ = false;
+    if (simThread_.joinable()) simThread_.join();
+}
 
-void GameScene::handleEvent(const sf::Event &ev) { if (ev.type == sf::Event::KeyPressed && ev.key.code == sf::Keyboard::Escape) returnToMenu_ = true; }
+void GameScene::handleEvent(const sf::Event &ev)
+{
+    if (ev.type == sf::Event::MouseMoved) {
+        const sf::Vector2f mouse((float)ev.mouseMove.x, (float)ev.mouseMove.y);
+        hoveredTile_ = -1;
+        for (size_t i = 0; i < tiles_.size() && tiles_.size() > 1; ++i) {
+            if (tiles_[i].contains(mouse)) { hoveredTile_ = (int)i; break; }
+        }
+        return;
+    }
+    if (ev.type != sf::Event::KeyPressed) return;
+    const sf::Keyboard::Key key = ev.key.code;
+    if (key == sf::Keyboard::Escape) returnToMenu_ = true;
+    else if (key >= sf::Keyboard::Num1 && key < sf::Keyboard::Num1 + SPEED_LEVELS) speedLevel_ = key - sf::Keyboard::Num1;
+    else if (key == sf::Keyboard::Add || key == sf::Keyboard::Equal) speedLevel_ = std::min(speedLevel_.load() + 1, SPEED_LEVELS - 1);
+    else if (key == sf::Keyboard::Subtract || key == sf::Keyboard::Hyphen) speedLevel_ = std::max(speedLevel_.load() - 1, 0);
+}
 
-SceneAction GameScene::update(sf::Time dt)
+SceneAction GameScene::update(sf::Time)
 {
     if (returnToMenu_) return SceneAction::ReturnToMenu;
-    if (isGameOver_) {
-        if (game_.getScore() > highScore_) highScore_ = game_.getScore();
-        aiAgent_.decayEpsilon();
-        std::cout << "Attempt: " << attempt_++ << " | Score: " << game_.getScore() << " | Epsilon: " << aiAgent_.epsilon << std::endl;
-        resetGame();
-        return SceneAction::None;
+    if (frames_.update()) hasFrame_ = true;
+    return SceneAction::None;
+}
+
+void GameScene::simLoop()
+{
+    using Clock = std::chrono::steady_clock;
+    // Unthrottled mode still hands over a frame at roughly display rate
+    const auto publishInterval = std::chrono::milliseconds(4);
+    const auto baseInterval = std::chrono::microseconds(Config::MOVE_INTERVAL.asMicroseconds());
+
+    publishFrame();
+    auto nextStep = Clock::now() + baseInterval;
+    auto lastPublish = Clock::now();
+    while (running_) {
+        const int level = speedLevel_;
+        if (level == SPEED_LEVELS - 1) {
+            simStep();
+            const auto now = Clock::now();
+            if (now - lastPublish >= publishInterval) { publishFrame(); lastPublish = now; }
+            nextStep = now;
+            continue;
+        }
+
+        const auto interval = baseInterval / (1 << level);
+        const auto now = Clock::now();
+        // Coming back from a faster speed: don't try to catch up
+        if (nextStep > now + interval) nextStep = now + interval;
+        if (now < nextStep) {
+            // Short naps keep speed changes and shutdown responsive
+            std::this_thread::sleep_for(std::min<Clock::duration>(nextStep - now, std::chrono::milliseconds(10)));
+            continue;
+        }
+        simStep();
+        publishFrame();
+        lastPublish = now;
+        nextStep = std::max(nextStep + interval, now);
+    }
+}
+
+// One tick: every board moves once
+void GameScene::simStep()
+{
+    for (Env& env : envs_) {
+        if (env.isGameOver) finishGame(env);
+        else stepEnv(env);
     }
+}
 
-    timeSinceLastMove_ += dt;
-    static int stepCounter = 0;
-    while (timeSinceLastMove_ >= moveInterval_)
-    {
-        timeSinceLastMove_ -= moveInterval_;
-        stepCounter++;
-
-        sf::Vector2i head = game_.getSnakeBody().front();
-        sf::Vector2i tail = game_.getSnakeBody().back();
-        sf::Vector2i food = game_.getFoodPos();
-        std::vector<double> state = aiAgent_.getState(game_.getGrid(), head, tail, food, direction_);
-
-        int action = aiAgent_.getAction(state);
-        sf::Vector2i moveDir;
-        if (action == 1)      moveDir = {direction_.y, -direction_.x};
-        else if (action == 2) moveDir = {-direction_.y, direction_.x};
-        else                  moveDir = direction_;
-
-        // Reward Calculation (matching trainer)
-        float dPre = (float)(std::abs(head.x - food.x) + std::abs(head.y - food.y));
-        direction_ = moveDir;
-        bool alive = game_.step(direction_);
-        sf::Vector2i nextHead = game_.getSnakeBody().front();
-        float dPost = (float)(std::abs(nextHead.x - food.x) + std::abs(nextHead.y - food.y));
-        
-        double reward = Config::REWARD_STEP;
-        if (!alive) { reward = Config::REWARD_DEATH; isGameOver_ = true; }
-        else if (nextHead == food) reward = Config::REWARD_FOOD;
-        else reward += (dPost < dPre) ? Config::REWARD_CLOSER : Config::REWARD_AWAY;
-
-        std::vector<double> nextState = aiAgent_.getState(game_.getGrid(), nextHead, game_.getSnakeBody().back(), food, direction_);
-        memory_.push_back({state, action, reward, nextState, isGameOver_});
-        if (memory_.size() > Config::REPLAY_MEMORY_SIZE) memory_.pop_front();
-
-        if (stepCounter % 5 == 0) {
-            std::vector<Experience> batch;
-            if (memory_.size() > Config::BATCH_SIZE) for (int i = 0; i < Config::BATCH_SIZE; ++i) batch.push_back(memory_[rand() % memory_.size()]);
-            else batch.assign(memory_.begin(), memory_.end());
-            aiAgent_.train(batch);
+void GameScene::finishGame(Env& env)
+{
+    const int score = env.game.getScore();
+    env.highScore = std::max(env.highScore, score);
+    if (score > highScore_) highScore_ = score;
+    aiAgent_.decayEpsilon();
+    games_++;
+
+    if (envs_.size() == 1) {
+        std::cout << "Attempt: " << env.attempt << " | Score: " << score << " | Epsilon: " << aiAgent_.epsilon << std::endl;
+    } else {
+        // One summary line per population's worth of games
+        recentScore_ += score;
+        if (++recentGames_ == (int)envs_.size()) {
+            std::cout << "Games: " << games_ << " | Mean Score: " << (double)recentScore_ / recentGames_ << " | Epsilon: " << aiAgent_.epsilon << std::endl;
+            recentGames_ = 0;
+            recentScore_ = 0;
         }
-        if (isGameOver_) break;
     }
-    return SceneAction::None;
+
+    env.attempt++;
+    env.game.reset();
+    env.direction = {1, 0};
+    env.isGameOver = false;
+}
+
+void GameScene::stepEnv(Env& env)
+{
+    SnakeGame& game = env.game;
+    steps_++;
+
+    sf::Vector2i head = game.getSnakeBody().front();
+    sf::Vector2i tail = game.getSnakeBody().back();
+    sf::Vector2i food = game.getFoodPos();
+    const FeatureSet features = aiAgent_.config.features;
+    std::vector<double> state = AiAgent::getState(features, game.getGrid(), head, tail, food, env.direction, game.getScore());
+
+    int action = aiAgent_.getAction(state);
+    sf::Vector2i moveDir = AiAgent::toDirection(action, env.direction);
+
+    // Reward Calculation (matching trainer)
+    float dPre = (float)(std::abs(head.x - food.x) + std::abs(head.y - food.y));
+    env.direction = moveDir;
+    bool alive = game.step(env.direction);
+    sf::Vector2i nextHead = game.getSnakeBody().front();
+    float dPost = (float)(std::abs(nextHead.x - food.x) + std::abs(nextHead.y - food.y));
+
+    const TrainingConfig& cfg = aiAgent_.config;
+    double reward = cfg.rewardStep;
+    if (!alive) { reward = cfg.rewardDeath; env.isGameOver = true; }
+    else if (nextHead == food) reward = cfg.rewardFood;
+    else reward += (dPost < dPre) ? cfg.rewardCloser : cfg.rewardAway;
+
+    std::vector<double> nextState = AiAgent::getState(features, game.getGrid(), nextHead, game.getSnakeBody().back(), food, env.direction, game.getScore());
+    memory_.push_back({state, action, reward, nextState, env.isGameOver});
+    if (memory_.size() > (size_t)cfg.replayMemorySize) memory_.pop_front();
+
+    if (steps_ % 5 == 0) trainFromMemory();
+}
+
+void GameScene::trainFromMemory()
+{
+    const int batchSize = aiAgent_.config.batchSize;
+    std::vector<Experience> batch;
+    if (memory_.size() > (size_t)batchSize) for (int i = 0; i < batchSize; ++i) batch.push_back(memory_[aiAgent_.rng() % memory_.size()]);
+    else batch.assign(memory_.begin(), memory_.end());
+    aiAgent_.train(batch);
+}
+
+void GameScene::publishFrame()
+{
+    Frame& frame = frames_.back();
+    frame.boards.resize(envs_.size());
+    for (size_t i = 0; i < envs_.size(); ++i) {
+        BoardSnapshot& board = frame.boards[i];
+        board.capture(envs_[i].game, envs_[i].direction);
+        board.highScore = envs_[i].highScore;
+        board.attempt = envs_[i].attempt;
+    }
+    frame.games = games_;
+    frame.highScore = highScore_;
+    frames_.publish();
+}
+
+void GameScene::setText(sf::Text& text, std::string& shown, const std::string& value)
+{
+    // setString rebuilds glyph geometry, so only touch texts whose value changed
+    if (value == shown) return;
+    shown = value;
+    text.setString(value);
+}
+
+void GameScene::refreshStats()
+{
+    const Frame& frame = frames_.front();
+    if (frame.boards.size() == 1) {
+        const BoardSnapshot& board = frame.boards[0];
+        setText(lengthText_, shownLength_, "Score: " + std::to_string(board.score));
+        setText(attemptText_, shownAttempt_, "Attempt: " + std::to_string(board.attempt));
+    } else {
+        int best = 0;
+        long long total = 0;
+        for (const BoardSnapshot& board : frame.boards) { best = std::max(best, board.score); total += board.score; }
+        char line[64];
+        std::snprintf(line, sizeof(line), "Mean: %.1f  Max: %d", (double)total / frame.boards.size(), best);
+        setText(lengthText_, shownLength_, line);
+        setText(attemptText_, shownAttempt_, "Games: " + std::to_string(frame.games));
+
+        std::string tile = "Hover a board for details";
+        if (hoveredTile_ >= 0 && hoveredTile_ < (int)frame.boards.size()) {
+            const BoardSnapshot& board = frame.boards[hoveredTile_];
+            tile = "Board " + std::to_string(hoveredTile_ + 1) + ": score " + std::to_string(board.score) +
+                   "\nBest " + std::to_string(board.highScore) + ", game " + std::to_string(board.attempt);
+        }
+        setText(tileText_, shownTile_, tile);
+    }
+    setText(highScoreText_, shownHighScore_, "High Score: " + std::to_string(frame.highScore));
+
+    const int speed = speedLevel_;
+    setText(speedText_, shownSpeed_, speed == SPEED_LEVELS - 1 ? "Speed: max" : "Speed: " + std::to_string(1 << speed) + "x");
 }
 
 void GameScene::draw(sf::RenderWindow &window)
 {
-    const float winW = static_cast<float>(window.getSize().x);
-    const float winH = static_cast<float>(window.getSize().y);
-    sf::RectangleShape frame; frame.setFillColor(Config::COLOR_FRAME);
-    frame.setSize({winW, offsetY_}); frame.setPosition(0, 0); window.draw(frame);
-    frame.setSize({winW, offsetY_}); frame.setPosition(0, winH - offsetY_); window.draw(frame);
-    frame.setSize({offsetX_, winH}); frame.setPosition(0, 0); window.draw(frame);
-    frame.setSize({rightMargin_, winH}); frame.setPosition(winW - rightMargin_, 0); window.draw(frame);
-
-    lengthText_.setString("Score: " + std::to_string(game_.getScore()));
-    highScoreText_.setString("High Score: " + std::to_string(highScore_));
-    attemptText_.setString("Attempt: " + std::to_string(attempt_));
-    window.draw(statsBg_); window.draw(statsTitle_); window.draw(lengthText_); window.draw(highScoreText_); window.draw(attemptText_);
-
-    const auto &grid = game_.getGrid();
-    for (int r = 0; r < rows_; ++r) {
-        for (int c = 0; c < cols_; ++c) {
-            const float x = offsetX_ + c * cellSize_;
-            const float y = offsetY_ + r * cellSize_;
-            sf::RectangleShape cell({cellSize_ - Config::CELL_PADDING, cellSize_ - Config::CELL_PADDING});
-            cell.setPosition(x + Config::CELL_PADDING * 0.5f, y + Config::CELL_PADDING * 0.5f);
-            if (grid[r][c].type == NodeType::Snake) cell.setFillColor((game_.getSnakeBody().front() == sf::Vector2i(c, r)) ? Config::COLOR_SNAKE_HEAD : Config::COLOR_SNAKE_BODY);
-            else if (grid[r][c].type == NodeType::Food) cell.setFillColor(Config::COLOR_FOOD);
-            else cell.setFillColor(Config::COLOR_BG);
-            window.draw(cell);
-            if (game_.getSnakeBody().front() == sf::Vector2i(c, r)) {
-                sf::CircleShape dot(cellSize_ * 0.2f); dot.setFillColor(sf::Color::Black);
-                dot.setOrigin(dot.getRadius(), dot.getRadius());
-                dot.setPosition(x + cellSize_ * 0.5f + direction_.x * (cellSize_ * 0.25f), y + cellSize_ * 0.5f + direction_.y * (cellSize_ * 0.25f));
-                window.draw(dot);
-            }
+    if (hasFrame_) {
+        const Frame& frame = frames_.front();
+        // Gauges show each board's length relative to the population's best
+        const float scale = 1.f / std::max(1, frame.highScore);
+        for (size_t i = 0; i < frame.boards.size() && i < boardIndex_.size(); ++i) {
+            const BoardSnapshot& board = frame.boards[i];
+            mesh_.update(boardIndex_[i], board.cells, board.head, board.direction);
+            if (i < scoreBar_.size()) mesh_.setBar(scoreBar_[i], board.score * scale);
         }
+        refreshStats();
     }
+
+    mesh_.draw(window);
+    window.draw(statsTitle_); window.draw(lengthText_); window.draw(highScoreText_); window.draw(attemptText_); window.draw(speedText_);
+    if (tiles_.size() > 1) window.draw(tileText_);
 }
 
-void GameScene::onDestroy() { aiAgent_.save("model.txt"); }
-std::string GameScene::getStats() const { return "High Score: " + std::to_string(highScore_); }
\ No newline at end of file
+void GameScene::onDestroy() { stopSimulation(); aiAgent_.save("model.txt"); }
+std::string GameScene::getStats() const { return "High Score: " + std::to_string(highScore_); }
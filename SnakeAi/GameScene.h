@@ -4,48 +4,105 @@
 #include <SFML/Graphics.hpp>
 #include <vector>
 #include <deque>
+#include <atomic>
+#include <thread>
 #include "Core/AiAgent.h"
 #include "Core/SnakeGame.h"
 #include "Core/Config.h"
+#include "Core/BoardSnapshot.h"
+#include "Core/TripleBuffer.h"
+#include "BoardMesh.h"
 
+/**
+ * @brief Watches the agent play and keep learning.
+ * Simulation and training run on a worker thread that hands finished frames
+ * to the renderer through a triple buffer, so training never stalls drawing.
+ * With more than one board the scene tiles a population of games, all played
+ * by the same agent, and draws every tile in a single call.
+ */
 class GameScene : public Scene {
 public:
-    GameScene(const sf::Vector2u& windowSize);
+    GameScene(const sf::Vector2u& windowSize, int boardCount = 1);
+    ~GameScene() override;
     void handleEvent(const sf::Event& ev) override;
     SceneAction update(sf::Time dt) override;
     void draw(sf::RenderWindow& window) override;
-    
+
     void onDestroy() override;
     std::string getStats() const override;
 
+    // Speed levels: 1x, 2x, 4x, 8x, 16x, then unthrottled
+    static const int SPEED_LEVELS = 6;
+
 private:
-    void resetGame();
+    // One game of the population
+    struct Env {
+        SnakeGame game;
+        sf::Vector2i direction = {1, 0};
+        bool isGameOver = false;
+        int attempt = 1;
+        int highScore = 0;
+    };
+
+    struct Frame {
+        std::vector<BoardSnapshot> boards;
+        int games = 0; // finished games across all boards
+        int highScore = 0;
+    };
 
-    SnakeGame game_;
+    // --- Simulation thread only ---
+    void simLoop();
+    void simStep();
+    void stepEnv(Env& env);
+    void finishGame(Env& env);
+    void trainFromMemory();
+    void publishFrame();
+    void stopSimulation();
+
+    std::vector<Env> envs_;
     AiAgent aiAgent_;
-    
+    std::deque<Experience> memory_;
+    long long steps_ = 0;
+    int games_ = 0;
+    int recentGames_ = 0;
+    long long recentScore_ = 0;
+
+    // --- Shared between threads ---
+    TripleBuffer<Frame> frames_;
+    std::atomic<bool> running_{false};
+    std::atomic<int> speedLevel_{0};
+    std::atomic<int> highScore_{0};
+    std::thread simThread_;
+
+    // --- Render thread only ---
+    void refreshStats();
+    void setText(sf::Text& text, std::string& shown, const std::string& value);
+
     int rows_;
     int cols_;
     float cellSize_;
     float offsetX_;
     float offsetY_;
     float rightMargin_;
-
-    sf::Vector2i direction_;
-    sf::Time moveInterval_;
-    sf::Time timeSinceLastMove_;
-    bool isGameOver_ = false;
     bool returnToMenu_ = false;
 
-    int highScore_ = 0;
-    int attempt_ = 1;
+    BoardMesh mesh_;
+    std::vector<int> boardIndex_;
+    std::vector<int> scoreBar_;
+    std::vector<sf::FloatRect> tiles_;
+    int hoveredTile_ = -1;
+    bool hasFrame_ = false;
 
     sf::Font uiFont_;
-    sf::RectangleShape statsBg_;
     sf::Text statsTitle_;
     sf::Text lengthText_;
     sf::Text highScoreText_;
     sf::Text attemptText_;
-
-    std::deque<Experience> memory_;
+    sf::Text speedText_;
+    sf::Text tileText_;
+    std::string shownLength_;
+    std::string shownHighScore_;
+    std::string shownAttempt_;
+    std::string shownSpeed_;
+    std::string shownTile_;
 };
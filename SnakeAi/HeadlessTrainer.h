@@ -1,124 +1,385 @@
 #pragma once
 #include "Core/SnakeGame.h"
 #include "Core/AiAgent.h"
+#include "Core/HamiltonianSolver.h"
+#include "Core/Teacher.h"
 #include "Core/Config.h"
+#include "Core/TrainingConfig.h"
+#include "Core/CheckpointWriter.h"
+#include "Core/CheckpointWatcher.h"
+#include "Core/Metrics.h"
+#include "Core/StateCache.h"
+#include "Core/ThreadPool.h"
+#include "Core/ReplayMemory.h"
+#include "Core/WindowFeatures.h"
+#include "Core/TrainingSchedule.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
 #include <iostream>
 #include <vector>
-#include <deque>
+#include <memory>
+#include <random>
+#include <string>
 
 /**
  * @brief HeadlessTrainer handles the AI training process without a GUI.
  * It supports synchronized parallel training via shared file system.
+ * Progress goes into a MetricsRegistry; the console only gets one summary line
+ * every logInterval attempts, and the registry can be mirrored to a
+ * Prometheus text file.
+ * Epsilon, learning rate and board size follow this worker's TrainingSchedule,
+ * which is re-applied after every load of the shared file; only a worker without
+ * saved schedule state takes the epsilon recorded in the first checkpoint.
  */
 class HeadlessTrainer {
 public:
     HeadlessTrainer(int maxAttempts = 1000, 
                     std::string loadFile = "model.txt", 
-                    std::string saveFile = "model.txt") 
-        : maxAttempts_(maxAttempts), loadFile_(loadFile), saveFile_(saveFile) {}
+                    std::string saveFile = "model.txt",
+                    const TrainingConfig& config = TrainingConfig(),
+                    unsigned int seed = std::random_device{}()) 
+        : game_(config.boardRows, config.boardCols),
+          aiAgent_(config, seed), cache_(config.stateCacheSize), expert_(config.boardRows, config.boardCols), schedule_(config), rng_(seed + 1), maxAttempts_(maxAttempts), loadFile_(loadFile), saveFile_(saveFile),
+          games_(metrics_.counter("snake_games_total", "Training games played")),
+          steps_(metrics_.counter("snake_steps_total", "Environment steps taken")),
+          score_(metrics_.histogram("snake_score", "Final score per training game", Histogram::exponentialBounds(1, 2, 10), 1000)),
+          loss_(metrics_.histogram("snake_loss", "Mean squared TD error per training batch", Histogram::exponentialBounds(0.01, 4, 10), 1000)),
+          checkpointSeconds_(metrics_.histogram("snake_checkpoint_write_seconds", "Checkpoint format + fsync + rename latency", Histogram::exponentialBounds(0.001, 4, 8), 100)),
+          stepsPerSecond_(metrics_.gauge("snake_steps_per_second", "Environment steps per second")),
+          epsilon_(metrics_.gauge("snake_epsilon", "Exploration rate")),
+          learningRate_(metrics_.gauge("snake_learning_rate", "Learning rate set by the schedule")),
+          boardCells_(metrics_.gauge("snake_board_cells", "Cells of the board currently trained on")),
+          plateaus_(metrics_.counter("snake_schedule_plateaus_total", "Score plateaus that raised epsilon and lowered the learning rate")),
+          promotions_(metrics_.counter("snake_curriculum_promotions_total", "Curriculum moves to a larger board")),
+          scheduleScore_(metrics_.gauge("snake_schedule_eval_score", "Greedy mean score on the schedule's board at the last window")),
+          replayOccupancy_(metrics_.gauge("snake_replay_occupancy", "Experiences held in replay memory")),
+          reloads_(metrics_.counter("snake_model_reloads_total", "Shared model reloads")),
+          cacheHits_(metrics_.counter("snake_state_cache_hits_total", "Feature/teacher lookups served from the state cache")),
+          cacheMisses_(metrics_.counter("snake_state_cache_misses_total", "Feature/teacher lookups computed from scratch")) {
+        if (!config.scheduleFile.empty()) scheduleRestored_ = schedule_.load(config.scheduleFile);
+        resizeBoard();
+        applySchedule();
+        game_.seed(seed);
+        evalSeed_ = seed + 2;
+        scheduleSeed_ = seed + 3;
+        ThreadPool::configureShared(config.threads, config.pinThreads);
+        if (!saveFile_.empty()) {
+            checkpoints_ = std::make_unique<CheckpointWriter>(saveFile_, config.checkpointKeep);
+        }
+        if (!loadFile_.empty()) watcher_ = std::make_unique<CheckpointWatcher>(loadFile_);
+    }
 
     void run() {
         std::cout << "--- Starting Synchronized Headless Training ---" << std::endl;
-        
-        for (int attempt = 1; attempt <= maxAttempts_; ++attempt) {
-            // 1. Sync: Load the latest global brain from other pods
-            aiAgent_.load(loadFile_);
-
-            game_.reset();
-            sf::Vector2i direction = {1, 0};
-            bool isGameOver = false;
-            int steps = 0;
-
-            while (!isGameOver && steps < 10000) {
-                sf::Vector2i head = game_.getSnakeBody().front();
-                sf::Vector2i tail = game_.getSnakeBody().back();
-                sf::Vector2i food = game_.getFoodPos();
-                
-                std::vector<double> state = aiAgent_.getState(game_.getGrid(), head, tail, food, direction);
-                
-                // --- BFS Teacher Logic ---
-                sf::Vector2i moveDir = game_.findBestMoveBFS();
-                int action = 0;
-                
-                if (moveDir != sf::Vector2i(0, 0)) {
-                    // Teacher found a path, force the action to follow it
-                    if (moveDir == sf::Vector2i(direction.y, -direction.x)) action = 1;      // Left
-                    else if (moveDir == sf::Vector2i(-direction.y, direction.x)) action = 2; // Right
-                    else action = 0;                                                         // Straight
-                } else {
-                    // No BFS path, let the AI guess (Survival Mode)
-                    action = aiAgent_.getAction(state);
-                    if (action == 1)      moveDir = {direction.y, -direction.x};
-                    else if (action == 2) moveDir = {-direction.y, direction.x};
-                    else                  moveDir = direction;
-                }
+        runAttempts(maxAttempts_);
+        if (replay_) replay_->flush();
+        saveSchedule();
+        if (!aiAgent_.config.metricsFile.empty()) metrics_.writeFile(aiAgent_.config.metricsFile);
+        std::cout << "--- Training Complete ---" << std::endl;
+    }
 
-                bool alive = game_.step(moveDir);
-                sf::Vector2i nextHead = game_.getSnakeBody().front();
-                
-                // Reward Logic
-                float dPre = (float)(std::abs(head.x - food.x) + std::abs(head.y - food.y));
-                float dPost = (float)(std::abs(nextHead.x - food.x) + std::abs(nextHead.y - food.y));
-
-                double reward = Config::REWARD_STEP;
-                if (!alive) {
-                    reward = Config::REWARD_DEATH;
-                    isGameOver = true;
-                } else if (nextHead == food) {
-                    reward = Config::REWARD_FOOD;
-                } else {
-                    reward += (dPost < dPre) ? Config::REWARD_CLOSER : Config::REWARD_AWAY;
-                }
+    // Plays and learns from `count` more games, returns their mean score.
+    // An empty load/save file disables syncing through the shared model.
+    double runAttempts(int count) {
+        double totalScore = 0.0;
+        for (int i = 0; i < count; ++i) {
+            const int attempt = ++attempts_;
 
-                std::vector<double> nextState = aiAgent_.getState(game_.getGrid(), nextHead, game_.getSnakeBody().back(), food, moveDir);
-                memory_.push_back({state, action, reward, nextState, isGameOver});
-                
-                if (memory_.size() > Config::REPLAY_MEMORY_SIZE) {
-                    memory_.pop_front();
-                }
+            // 1. Sync: Take the latest global brain from other pods once the watcher
+            // has read it in the background. While our own snapshot is still being
+            // written, the file is older than our weights.
+            if (attempt == 1 && !loadFile_.empty()) {
+                // Without saved worker state, carry on from the checkpoint's epsilon
+                if (CheckpointWriter::loadLatest(aiAgent_, loadFile_) && !scheduleRestored_) schedule_.adoptEpsilon(aiAgent_.epsilon);
+                applySchedule();
+            } else if (watcher_ && (!checkpoints_ || checkpoints_->idle()) &&
+                       watcher_->take(latest_, checkpoints_ ? checkpoints_->lastWritten() : FileStamp()) && aiAgent_.restore(latest_)) {
+                reloads_.add();
+                applySchedule(); // the checkpoint carries another worker's epsilon and resets the learning rate
+            }
+
+            const int score = playTrainingGame();
+            totalScore += score;
+
+            // 2. Post-game schedule: epsilon every game; learning rate and curriculum
+            // from the network's own greedy play once per window
+            advanceSchedule();
+
+            // 3. Share: Save my findings back to the global brain (written in the background)
+            if (checkpoints_ && attempt % 10 == 0) {
+                checkpoints_->submit(aiAgent_);
+                if (watcher_) watcher_->discard(); // anything read so far is older than these weights
+            }
+            if (replay_ && attempt % 10 == 0) replay_->flush();
+            if (attempt % 10 == 0) saveSchedule();
+
+            recordAttempt(score);
+            if (verbose_ && attempt % aiAgent_.config.logInterval == 0) logSummary(attempt);
+        }
+        return count > 0 ? totalScore / count : 0.0;
+    }
+
+    // Greedy games played by the network alone (no teacher, no learning), on the
+    // configured board even while the curriculum trains on a smaller one.
+    double evaluate(int games) {
+        const unsigned int firstSeed = evalSeed_ + (unsigned int)evalPlayed_;
+        evalPlayed_ += std::max(0, games);
+        return evaluateOn(games, aiAgent_.config.boardRows, aiAgent_.config.boardCols, firstSeed);
+    }
+
+    void setVerbose(bool verbose) { verbose_ = verbose; }
+    int attempts() const { return attempts_; }
+    const MetricsRegistry& metrics() const { return metrics_; }
+    const TrainingSchedule& schedule() const { return schedule_; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    void advanceSchedule() {
+        if (schedule_.endGame() && schedule_.needsEvaluation()) {
+            // The same start positions every window, so means are comparable
+            const double mean = evaluateOn(aiAgent_.config.scheduleEvalGames, schedule_.boardRows(), schedule_.boardCols(), scheduleSeed_);
+            scheduleScore_.set(mean);
+            const TrainingSchedule::Event event = schedule_.endWindow(mean);
+            if (event == TrainingSchedule::Event::Promoted) {
+                promotions_.add();
+                resizeBoard();
+                game_.seed(rng_());
+                if (verbose_) std::cout << "Curriculum: greedy mean " << mean << ", moving to a "
+                                        << schedule_.boardRows() << "x" << schedule_.boardCols() << " board" << std::endl;
+            } else if (event == TrainingSchedule::Event::Plateau) {
+                plateaus_.add();
+                if (verbose_) std::cout << "Schedule: score plateau at greedy mean " << mean << ", epsilon "
+                                        << schedule_.epsilon() << ", learning rate " << schedule_.learningRate() << std::endl;
+            }
+        }
+        applySchedule();
+    }
 
-                if (steps % 5 == 0) {
-                    trainFromMemory();
+    // Mean score of greedy games on a rows x cols board; a game also ends once the
+    // snake goes a full board's worth of steps without eating. Games run in
+    // parallel on the shared thread pool, game g with seed firstSeed + g.
+    double evaluateOn(int games, int rows, int cols, unsigned int firstSeed) {
+        if (games <= 0) return 0.0;
+        const int patience = rows * cols;
+
+        std::vector<int> scores(games);
+        ThreadPool::shared().parallelFor(0, games, [&](size_t lo, size_t hi) {
+            NeuralNetwork::Workspace ws;
+            for (size_t g = lo; g < hi; ++g) {
+                SnakeGame game(rows, cols);
+                game.seed(firstSeed + (unsigned int)g);
+                game.reset();
+                sf::Vector2i direction = {1, 0};
+                int sinceFood = 0;
+                int lastScore = game.getScore();
+                while (sinceFood < patience) {
+                    const std::vector<double>& q = greedyOutputs(game, direction, ws);
+                    direction = AiAgent::toDirection((int)(std::max_element(q.begin(), q.end()) - q.begin()), direction);
+                    if (!game.step(direction)) break;
+                    if (game.getScore() != lastScore) { lastScore = game.getScore(); sinceFood = 0; }
+                    else sinceFood++;
                 }
+                scores[g] = game.getScore();
+            }
+        });
+
+        double totalScore = 0.0;
+        for (int score : scores) totalScore += score;
+        return totalScore / games;
+    }
+
+    void applySchedule() {
+        aiAgent_.epsilon = schedule_.epsilon();
+        aiAgent_.brain.learningRate = schedule_.learningRate();
+    }
+
+    // Game and teacher for the schedule's board; a new board size gets new Zobrist keys, so cached positions never collide
+    void resizeBoard() {
+        if (game_.getRows() == schedule_.boardRows() && game_.getCols() == schedule_.boardCols()) return;
+        game_ = SnakeGame(schedule_.boardRows(), schedule_.boardCols());
+        expert_ = HamiltonianSolver(schedule_.boardRows(), schedule_.boardCols());
+    }
 
-                direction = moveDir;
-                steps++;
+    void saveSchedule() {
+        const std::string& file = aiAgent_.config.scheduleFile;
+        if (!file.empty() && !schedule_.save(file)) std::cerr << "Error: Could not save schedule state to " << file << std::endl;
+    }
+
+    void recordAttempt(int score) {
+        games_.add();
+        score_.observe(score);
+        epsilon_.set(aiAgent_.epsilon);
+        learningRate_.set(schedule_.learningRate());
+        boardCells_.set((double)game_.getRows() * game_.getCols());
+        replayOccupancy_.set(replay_ ? (double)replay_->size() : 0.0);
+        cacheHits_.add((double)cache_.hits() - cacheHits_.value());
+        cacheMisses_.add((double)cache_.misses() - cacheMisses_.value());
+        if (checkpoints_ && checkpoints_->writes() != checkpointWrites_) {
+            checkpointWrites_ = checkpoints_->writes();
+            checkpointSeconds_.observe(checkpoints_->lastWriteSeconds());
+        }
+
+        // Step rate over at least a second, so short games don't make it jitter
+        const Clock::time_point now = Clock::now();
+        const double elapsed = std::chrono::duration<double>(now - rateStart_).count();
+        if (elapsed >= 1.0) {
+            stepsPerSecond_.set((steps_.value() - rateSteps_) / elapsed);
+            rateSteps_ = steps_.value();
+            rateStart_ = now;
+        }
+
+        const std::string& file = aiAgent_.config.metricsFile;
+        if (!file.empty() && std::chrono::duration<double>(now - lastMetricsWrite_).count() >= aiAgent_.config.metricsInterval) {
+            metrics_.writeFile(file);
+            lastMetricsWrite_ = now;
+        }
+    }
+
+    void logSummary(int attempt) {
+        const Histogram::Summary score = score_.recent();
+        const Histogram::Summary loss = loss_.recent();
+        const double lookups = cacheHits_.value() + cacheMisses_.value();
+        char line[320];
+        std::snprintf(line, sizeof(line),
+                      "Attempt: %d | Score: mean %.1f p50 %.0f max %.0f | Steps/s: %.0f | Epsilon: %.4g | LR: %.3g | Board: %dx%d | Loss: %.4g | Replay: %.0f | Cache: %.0f%% | Checkpoint: %.1f ms",
+                      attempt, score.mean, score.p50, score.max, stepsPerSecond_.value(), epsilon_.value(), learningRate_.value(),
+                      game_.getRows(), game_.getCols(), loss.mean,
+                      replayOccupancy_.value(), lookups > 0 ? 100.0 * cacheHits_.value() / lookups : 0.0,
+                      checkpointSeconds_.recent().p50 * 1000.0);
+        std::cout << line << std::endl;
+    }
+
+    int playTrainingGame() {
+        game_.reset();
+        sf::Vector2i direction = {1, 0};
+        bool isGameOver = false;
+        int steps = 0;
+
+        while (!isGameOver && steps < 10000) {
+            sf::Vector2i head = game_.getSnakeBody().front();
+            sf::Vector2i food = game_.getFoodPos();
+            
+            std::vector<double> state = observe(game_, direction);
+            
+            // --- Teacher Logic (BFS, Hamiltonian cycle when no safe food path) ---
+            sf::Vector2i moveDir = cache_.teacherMove(game_, expert_);
+            int action = 0;
+            
+            if (moveDir != sf::Vector2i(0, 0)) {
+                // Teacher found a move, force the action to follow it
+                action = AiAgent::toAction(moveDir, direction);
+            } else {
+                // Every move is fatal, let the AI guess (Survival Mode)
+                action = aiAgent_.getAction(state);
+                moveDir = AiAgent::toDirection(action, direction);
             }
 
-            // 2. Post-game cleanup and decay
-            aiAgent_.decayEpsilon();
+            bool alive = game_.step(moveDir);
+            sf::Vector2i nextHead = game_.getSnakeBody().front();
             
-            // 3. Share: Save my findings back to the global brain
-            if (attempt % 10 == 0) {
-                aiAgent_.save(saveFile_);
+            // Reward Logic
+            const TrainingConfig& cfg = aiAgent_.config;
+            float dPre = (float)(std::abs(head.x - food.x) + std::abs(head.y - food.y));
+            float dPost = (float)(std::abs(nextHead.x - food.x) + std::abs(nextHead.y - food.y));
+
+            double reward = cfg.rewardStep;
+            if (!alive) {
+                reward = cfg.rewardDeath;
+                isGameOver = true;
+            } else if (nextHead == food) {
+                reward = cfg.rewardFood;
+            } else {
+                reward += (dPost < dPre) ? cfg.rewardCloser : cfg.rewardAway;
             }
 
-            // Output EVERY attempt
-            std::cout << "Attempt: " << attempt 
-                      << " | Score: " << game_.getScore() 
-                      << " | Epsilon: " << aiAgent_.epsilon << std::endl;
+            // After eating, the next state still sees the old food position, which no cached position matches
+            std::vector<double> nextState = (alive && game_.getFoodPos() == food)
+                ? observe(game_, moveDir)
+                : AiAgent::getState(cfg.features, game_.getGrid(), nextHead, game_.getSnakeBody().back(), food, moveDir, game_.getScore());
+            replay().push({state, action, reward, nextState, isGameOver});
+
+            if (steps % 5 == 0) {
+                trainFromMemory();
+            }
+
+            direction = moveDir;
+            steps++;
         }
-        
-        std::cout << "--- Training Complete ---" << std::endl;
+        steps_.add(steps);
+        return game_.getScore();
     }
 
-private:
-    void trainFromMemory() {
-        std::vector<Experience> batch;
-        if (memory_.size() > Config::BATCH_SIZE) {
-            for (int i = 0; i < Config::BATCH_SIZE; ++i) {
-                batch.push_back(memory_[rand() % memory_.size()]);
-            }
-        } else {
-            batch.assign(memory_.begin(), memory_.end());
+    // Network input for the game's current position; ray features go through the state cache
+    std::vector<double> observe(const SnakeGame& game, sf::Vector2i direction) {
+        if (aiAgent_.config.features == FeatureSet::Rays) return cache_.features(game, direction);
+        const auto& body = game.getSnakeBody();
+        return AiAgent::getState(FeatureSet::Window, game.getGrid(), body.front(), body.back(), game.getFoodPos(), direction, (int)body.size());
+    }
+
+    // Network outputs for evaluation; window features skip the dense expansion and use the bit-packed first layer
+    const std::vector<double>& greedyOutputs(const SnakeGame& game, sf::Vector2i direction, NeuralNetwork::Workspace& ws) {
+        if (aiAgent_.config.features != FeatureSet::Window) return aiAgent_.brain.forward(observe(game, direction), ws);
+        const auto& body = game.getSnakeBody();
+        const WindowObservation window = encodeWindow(game.getGrid(), body.front(), body.back(), game.getFoodPos(), direction, (int)body.size());
+        return aiAgent_.brain.forwardBits(window.bits, WindowObservation::BITS, window.extras, WindowObservation::EXTRAS, ws);
+    }
+
+    // Created on first use, once the first checkpoint load has settled the feature set
+    ReplayMemory& replay() {
+        if (!replay_ || replay_->featureCount() != AiAgent::stateSize(aiAgent_.config.features)) {
+            replay_.reset(); // releases the spill file before it is reopened
+            replay_ = std::make_unique<ReplayMemory>(ReplayMemory::settingsFor(aiAgent_.config));
         }
-        aiAgent_.train(batch);
+        return *replay_;
+    }
+
+    void trainFromMemory() {
+        replay().sample(aiAgent_.config.batchSize, rng_, batch_);
+        loss_.observe(aiAgent_.train(batch_));
     }
 
     SnakeGame game_;
     AiAgent aiAgent_;
-    std::deque<Experience> memory_;
+    StateCache cache_;
+    HamiltonianSolver expert_;
+    TrainingSchedule schedule_;
+    bool scheduleRestored_ = false; // worker state came from scheduleFile
+    std::unique_ptr<ReplayMemory> replay_;
+    std::vector<Experience> batch_;
+    std::mt19937 rng_;
+    unsigned int evalSeed_ = 0;
+    unsigned int scheduleSeed_ = 0;
+    long long evalPlayed_ = 0;
     int maxAttempts_;
+    int attempts_ = 0;
+    bool verbose_ = true;
     std::string loadFile_;
     std::string saveFile_;
+    std::unique_ptr<CheckpointWriter> checkpoints_;
+    std::unique_ptr<CheckpointWatcher> watcher_;
+    Checkpoint latest_; // reused for every reload
+    long long checkpointWrites_ = 0;
+
+    MetricsRegistry metrics_;
+    Counter& games_;
+    Counter& steps_;
+    Histogram& score_;
+    Histogram& loss_;
+    Histogram& checkpointSeconds_;
+    Gauge& stepsPerSecond_;
+    Gauge& epsilon_;
+    Gauge& learningRate_;
+    Gauge& boardCells_;
+    Counter& plateaus_;
+    Counter& promotions_;
+    Gauge& scheduleScore_;
+    Gauge& replayOccupancy_;
+    Counter& reloads_;
+    Counter& cacheHits_;
+    Counter& cacheMisses_;
+    Clock::time_point rateStart_ = Clock::now();
+    double rateSteps_ = 0.0;
+    Clock::time_point lastMetricsWrite_ = Clock::now();
 };
\ No newline at end of file
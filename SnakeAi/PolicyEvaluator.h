@@ -0,0 +1,199 @@
+#pragma once
+#include "Core/SnakeGame.h"
+#include "Core/AiAgent.h"
+#include "Core/RolloutPlanner.h"
+#include "Core/CompiledPolicy.h"
+#include "Core/WindowFeatures.h"
+#include "Core/Config.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Plays greedy games with a trained model, optionally searching each move
+ * with the RolloutPlanner, and reports score and per-move decision latency.
+ * A budget of 0 plays the network alone, which gives the baseline to compare against.
+ */
+class PolicyEvaluator {
+public:
+    PolicyEvaluator(int games, std::string modelFile, const RolloutPlanner::Settings& planner)
+        : games_(games), modelFile_(std::move(modelFile)), settings_(planner) {}
+
+    void run() {
+        AiAgent agent;
+        if (!agent.load(modelFile_)) std::cout << "Evaluating an untrained network." << std::endl;
+        agent.epsilon = 0.0;
+
+        std::unique_ptr<RolloutPlanner> planner;
+        if (settings_.budgetMs > 0) planner = std::make_unique<RolloutPlanner>(settings_);
+        std::cout << "--- Evaluating " << modelFile_ << " over " << games_ << " games (";
+        if (planner) std::cout << "rollouts, " << settings_.budgetMs << " ms/move";
+        else std::cout << "network only";
+        std::cout << ") ---" << std::endl;
+
+        const int patience = agent.config.boardRows * agent.config.boardCols;
+        std::vector<double> latencies;
+        long long totalScore = 0;
+        long long rollouts = 0;
+        int bestScore = 0;
+
+        SnakeGame game(agent.config.boardRows, agent.config.boardCols); // the board the model was trained on
+        game.seed(12345); // same food sequence for every configuration
+        for (int g = 0; g < games_; ++g) {
+            game.reset();
+            sf::Vector2i direction = {1, 0};
+            int sinceFood = 0;
+            int lastScore = game.getScore();
+            while (sinceFood < patience && game.getFoodPos().x != -1) {
+                const auto start = std::chrono::steady_clock::now();
+                const auto& body = game.getSnakeBody();
+                std::vector<double> state = AiAgent::getState(agent.config.features, game.getGrid(), body.front(), body.back(), game.getFoodPos(), direction, (int)body.size());
+                std::vector<double> q = agent.qValues(state);
+                sf::Vector2i move;
+                if (planner) {
+                    move = planner->plan(game, direction, q);
+                    rollouts += planner->lastRollouts();
+                } else {
+                    move = AiAgent::toDirection((int)(std::max_element(q.begin(), q.end()) - q.begin()), direction);
+                }
+                latencies.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+
+                if (!game.step(move)) break;
+                direction = move;
+                if (game.getScore() != lastScore) { lastScore = game.getScore(); sinceFood = 0; }
+                else sinceFood++;
+            }
+            totalScore += game.getScore();
+            bestScore = std::max(bestScore, game.getScore());
+        }
+
+        std::sort(latencies.begin(), latencies.end());
+        auto quantile = [&](double q) { return latencies.empty() ? 0.0 : latencies[std::min(latencies.size() - 1, (size_t)(q * latencies.size()))]; };
+        char line[256];
+        std::snprintf(line, sizeof(line), "Avg Score: %.2f | Best: %d | Moves: %zu | Latency ms p50 %.3f p99 %.3f max %.3f | Rollouts/move: %.0f",
+                      games_ > 0 ? (double)totalScore / games_ : 0.0, bestScore, latencies.size(),
+                      quantile(0.50), quantile(0.99), latencies.empty() ? 0.0 : latencies.back(),
+                      latencies.empty() ? 0.0 : (double)rollouts / latencies.size());
+        std::cout << line << std::endl;
+    }
+
+private:
+    int games_;
+    std::string modelFile_;
+    RolloutPlanner::Settings settings_;
+};
+
+/**
+ * @brief Single-state decision latency of a frozen model: AiAgent::getAction
+ * against the CompiledPolicy of the same weights (compiled from the checkpoint,
+ * or loaded from an exported policy file). The states come from games the
+ * model plays itself, and only the decision is timed, not feature extraction.
+ */
+class PolicyLatencyBenchmark {
+public:
+    PolicyLatencyBenchmark(std::string modelFile, std::string policyFile, int decisions)
+        : modelFile_(std::move(modelFile)), policyFile_(std::move(policyFile)), decisions_(decisions) {}
+
+    bool run() {
+        AiAgent agent;
+        if (!agent.load(modelFile_)) std::cout << "Benchmarking an untrained network." << std::endl;
+        agent.epsilon = 0.0;
+        collectStates(agent);
+
+        bool ok = true;
+        const bool shaped = withCompiledPolicy(agent.config.layers, [&](auto& policy) {
+            ok = policyFile_.empty() ? policy.compile(agent.brain, agent.config.features) : policy.load(policyFile_);
+            if (ok) report(agent, policy);
+        });
+        if (!shaped) {
+            std::cerr << "Error: No compiled policy for topology " << agent.config.topologyString() << std::endl;
+            return false;
+        }
+        return ok;
+    }
+
+private:
+    static constexpr int STATES = 4096;
+
+    // Greedy games of the model itself; a fatal choice is swapped for a safe move so games last
+    void collectStates(AiAgent& agent) {
+        SnakeGame game(agent.config.boardRows, agent.config.boardCols);
+        game.seed(12345);
+        game.reset();
+        sf::Vector2i direction = {1, 0};
+        const int patience = agent.config.boardRows * agent.config.boardCols;
+        int sinceFood = 0, lastScore = game.getScore();
+        while ((int)states_.size() < STATES) {
+            const auto& body = game.getSnakeBody();
+            states_.push_back(AiAgent::getState(agent.config.features, game.getGrid(), body.front(), body.back(), game.getFoodPos(), direction, (int)body.size()));
+            if (agent.config.features == FeatureSet::Window) {
+                windows_.push_back(encodeWindow(game.getGrid(), body.front(), body.back(), game.getFoodPos(), direction, (int)body.size()));
+            }
+            sf::Vector2i move = AiAgent::toDirection(agent.getAction(states_.back()), direction);
+            for (int a = 0; a < AiAgent::ACTION_COUNT && isFatal(game, move); ++a) move = AiAgent::toDirection(a, direction);
+            if (!game.step(move) || game.getFoodPos().x == -1 || sinceFood > patience) {
+                game.reset();
+                direction = {1, 0};
+                sinceFood = 0;
+                lastScore = game.getScore();
+                continue;
+            }
+            direction = move;
+            if (game.getScore() != lastScore) { lastScore = game.getScore(); sinceFood = 0; }
+            else sinceFood++;
+        }
+    }
+
+    static bool isFatal(const SnakeGame& game, sf::Vector2i move) {
+        const auto& body = game.getSnakeBody();
+        const sf::Vector2i next = body.front() + move;
+        if (next.x < 0 || next.y < 0 || next.x >= game.getCols() || next.y >= game.getRows()) return true;
+        return game.getGrid()[next.y][next.x].type == NodeType::Snake && next != body.back();
+    }
+
+    template <typename Policy>
+    void report(AiAgent& agent, const Policy& policy) {
+        std::vector<int> reference(states_.size());
+        const double network = timePerDecision([&](size_t i) { return reference[i] = agent.getAction(states_[i]); });
+        const double compiled = timePerDecision([&](size_t i) { return policy.act(states_[i]); });
+
+        int agree = 0;
+        for (size_t i = 0; i < states_.size(); ++i) agree += policy.act(states_[i]) == reference[i];
+
+        std::cout << "--- Decision latency of " << modelFile_ << " (" << agent.config.topologyString() << ", "
+                  << featureSetName(agent.config.features) << " features, " << decisions_ << " decisions) ---" << std::endl;
+        char line[160];
+        std::snprintf(line, sizeof(line), "AiAgent::getAction   %8.1f ns/decision", network);
+        std::cout << line << std::endl;
+        std::snprintf(line, sizeof(line), "CompiledPolicy       %8.1f ns/decision (%.1fx)", compiled, compiled > 0 ? network / compiled : 0.0);
+        std::cout << line << std::endl;
+        if constexpr (Policy::INPUTS == WindowObservation::INPUT_SIZE) {
+            const double bits = timePerDecision([&](size_t i) { return policy.act(windows_[i]); });
+            std::snprintf(line, sizeof(line), "CompiledPolicy bits  %8.1f ns/decision (%.1fx)", bits, bits > 0 ? network / bits : 0.0);
+            std::cout << line << std::endl;
+        }
+        std::snprintf(line, sizeof(line), "Same action as the double network: %.2f%% of %zu states", 100.0 * agree / states_.size(), states_.size());
+        std::cout << line << std::endl;
+    }
+
+    template <typename Decide>
+    double timePerDecision(Decide&& decide) {
+        int sink = 0;
+        const auto start = std::chrono::steady_clock::now();
+        for (int d = 0; d < decisions_; ++d) sink += decide((size_t)d % states_.size());
+        const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        sink_ += sink; // keeps the decisions from being optimized away
+        return ns / std::max(1, decisions_);
+    }
+
+    std::string modelFile_;
+    std::string policyFile_;
+    int decisions_;
+    std::vector<std::vector<double>> states_;
+    std::vector<WindowObservation> windows_;
+    long long sink_ = 0;
+};
@@ -0,0 +1,247 @@
+#pragma once
+#include "Core/SnakeGame.h"
+#include "Core/AiAgent.h"
+#include "Core/HamiltonianSolver.h"
+#include "Core/Teacher.h"
+#include "Core/StateCache.h"
+#include "Core/DemoDataset.h"
+#include "Core/Config.h"
+#include "Core/TrainingConfig.h"
+#include "Core/ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Generates (state, teacher action) demonstrations in parallel.
+ * Each shard is one task on the shared thread pool: it plays its own games with
+ * the BFS/Hamiltonian teacher and streams its samples into a separate file in
+ * the output directory. By default there is one shard per pool thread.
+ * Features and teacher moves are memoised in a state cache shared by all workers.
+ */
+class DemoGenerator {
+public:
+    DemoGenerator(long long samples, std::string outDir, int workers = 0)
+        : samples_(samples), outDir_(std::move(outDir)),
+          workers_(workers > 0 ? workers : ThreadPool::shared().concurrency()) {}
+
+    void run() {
+        std::cout << "--- Generating " << samples_ << " demonstrations with " << workers_ << " workers ---" << std::endl;
+        std::filesystem::create_directories(outDir_);
+
+        auto start = std::chrono::steady_clock::now();
+        const unsigned int baseSeed = std::random_device{}();
+        ThreadPool::shared().parallelFor(0, (size_t)workers_, [&](size_t lo, size_t hi) {
+            for (size_t w = lo; w < hi; ++w) {
+                const long long share = samples_ / workers_ + ((long long)w < samples_ % workers_ ? 1 : 0);
+                worker((int)w, share, baseSeed + (unsigned int)w);
+            }
+        });
+
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        const double lookups = (double)(cache_.hits() + cache_.misses());
+        std::cout << "Wrote " << produced_.load() << " samples to " << outDir_
+                  << " (" << (seconds > 0 ? produced_.load() / seconds : 0.0) << " samples/sec, "
+                  << (lookups > 0 ? 100.0 * cache_.hits() / lookups : 0.0) << "% cache hits)" << std::endl;
+    }
+
+private:
+    void worker(int id, long long samples, unsigned int seed) {
+        SnakeGame game;
+        game.seed(seed);
+        game.reset();
+        HamiltonianSolver expert;
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<double> coin(0.0, 1.0);
+
+        DemoShardWriter writer;
+        const std::string path = (std::filesystem::path(outDir_) / ("demo-" + std::to_string(id) + ".shard")).string();
+
+        sf::Vector2i direction = {1, 0};
+        int steps = 0;
+        long long written = 0;
+        while (written < samples) {
+            sf::Vector2i move = cache_.teacherMove(game, expert);
+            bool alive = false;
+
+            if (move == sf::Vector2i(0, 0)) {
+                alive = false; // trapped, nothing worth recording
+            } else if (move == sf::Vector2i(-direction.x, -direction.y)) {
+                alive = game.step(move); // reversing is not a relative action
+                direction = move;
+            } else {
+                std::vector<double> state = cache_.features(game, direction);
+                if (written == 0 && !writer.open(path, (int)state.size())) return;
+                writer.write(state, AiAgent::toAction(move, direction));
+                written++;
+
+                // Occasionally deviate from the teacher so the dataset also
+                // covers states off the expert trajectory.
+                int executed = AiAgent::toAction(move, direction);
+                if (coin(rng) < EXPLORATION_NOISE) executed = (int)(rng() % 3);
+                direction = AiAgent::toDirection(executed, direction);
+                alive = game.step(direction);
+            }
+
+            steps++;
+            if (!alive || steps >= 10000 || game.getFoodPos().x == -1) {
+                game.reset();
+                direction = {1, 0};
+                steps = 0;
+            }
+        }
+        writer.close();
+        produced_ += written;
+    }
+
+    static constexpr double EXPLORATION_NOISE = 0.1;
+
+    long long samples_;
+    std::string outDir_;
+    int workers_;
+    std::atomic<long long> produced_{0};
+    StateCache cache_{1 << 16};
+};
+
+/**
+ * @brief Behaviour cloning: fits the network to the teacher's actions with a
+ * softmax cross-entropy loss and saves the result as a regular checkpoint.
+ * Each batch is one gradient step: its rows are split into slices whose
+ * gradients are summed on the shared thread pool and applied once. The sum is
+ * applied at the configured learning rate, i.e. the mean gradient at learning
+ * rate * batch size, so a batch of 1 is the old per-sample SGD step.
+ */
+class SupervisedTrainer {
+public:
+    SupervisedTrainer(std::string dataDir, int epochs, std::string saveFile, int batchSize = 1024,
+                      const TrainingConfig& config = TrainingConfig())
+        : aiAgent_(config), dataDir_(std::move(dataDir)), epochs_(epochs), saveFile_(std::move(saveFile)), batchSize_(batchSize) {
+        ThreadPool::configureShared(config.threads, config.pinThreads);
+    }
+
+    void run() {
+        std::vector<std::string> shards;
+        if (std::filesystem::is_directory(dataDir_)) {
+            for (const auto& entry : std::filesystem::directory_iterator(dataDir_)) {
+                if (entry.path().extension() == ".shard") shards.push_back(entry.path().string());
+            }
+        }
+        std::sort(shards.begin(), shards.end());
+
+        DemoDatasetReader reader(shards, batchSize_, std::random_device{}());
+        if (reader.size() == 0) {
+            std::cerr << "Error: No demonstrations found in " << dataDir_ << std::endl;
+            return;
+        }
+        if (reader.featureCount() != aiAgent_.brain.layers[0].size) {
+            std::cerr << "Error: Demonstrations have " << reader.featureCount()
+                      << " features, network expects " << aiAgent_.brain.layers[0].size << std::endl;
+            return;
+        }
+
+        std::cout << "--- Pretraining on " << reader.size() << " demonstrations from " << shards.size() << " shards ---" << std::endl;
+
+        DemoBatch batch;
+        for (int epoch = 1; epoch <= epochs_; ++epoch) {
+            auto start = std::chrono::steady_clock::now();
+            double lossSum = 0.0;
+            long long seen = 0, correct = 0;
+
+            reader.startEpoch();
+            while (reader.nextBatch(batch)) {
+                const BatchResult result = trainBatch(batch);
+                lossSum += result.loss;
+                correct += result.correct;
+                seen += batch.size();
+            }
+
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            std::cout << "Epoch: " << epoch
+                      << " | Loss: " << lossSum / std::max(1LL, seen)
+                      << " | Accuracy: " << (double)correct / std::max(1LL, seen)
+                      << " | Samples/sec: " << (seconds > 0 ? seen / seconds : 0.0) << std::endl;
+        }
+
+        // Start RL from the cloned policy with little exploration left
+        aiAgent_.epsilon = PRETRAINED_EPSILON;
+        aiAgent_.save(saveFile_);
+        std::cout << "--- Pretrained model saved to " << saveFile_ << " ---" << std::endl;
+    }
+
+private:
+    struct BatchResult {
+        double loss = 0.0;
+        long long correct = 0;
+    };
+
+    struct Slice {
+        NeuralNetwork::Workspace workspace;
+        NeuralNetwork::Gradient gradient;
+        std::vector<double> input, probs, errors;
+        BatchResult result;
+    };
+
+    // One step along the batch's summed cross-entropy gradient
+    BatchResult trainBatch(const DemoBatch& batch) {
+        NeuralNetwork& brain = aiAgent_.brain;
+        ThreadPool& pool = ThreadPool::shared();
+        const size_t rows = (size_t)batch.size();
+        const size_t slices = std::min(rows, (size_t)pool.concurrency());
+        if (slices_.size() < slices) slices_.resize(slices);
+        const int outputs = brain.layers.back().size;
+
+        pool.parallelFor(0, slices, [&](size_t lo, size_t hi) {
+            for (size_t s = lo; s < hi; ++s) {
+                Slice& slice = slices_[s];
+                brain.initGradient(slice.gradient);
+                slice.input.resize(batch.featureCount);
+                slice.probs.resize(outputs);
+                slice.errors.resize(outputs);
+                slice.result = BatchResult();
+                for (size_t i = rows * s / slices; i < rows * (s + 1) / slices; ++i) {
+                    const float* row = batch.row((int)i);
+                    std::copy(row, row + batch.featureCount, slice.input.begin());
+                    const int label = batch.actions[i];
+
+                    const std::vector<double>& q = brain.forward(slice.input, slice.workspace);
+                    if (std::max_element(q.begin(), q.end()) - q.begin() == label) slice.result.correct++;
+                    softmax(q, slice.probs);
+                    slice.result.loss -= std::log(std::max(slice.probs[label], 1e-12));
+                    for (int k = 0; k < outputs; ++k) slice.errors[k] = (k == label ? 1.0 : 0.0) - slice.probs[k];
+                    brain.accumulateGradient(slice.errors, slice.workspace, slice.gradient);
+                }
+            }
+        });
+
+        BatchResult total = slices_[0].result;
+        for (size_t s = 1; s < slices; ++s) {
+            slices_[0].gradient.add(slices_[s].gradient);
+            total.loss += slices_[s].result.loss;
+            total.correct += slices_[s].result.correct;
+        }
+        brain.applyGradient(slices_[0].gradient);
+        return total;
+    }
+
+    static void softmax(const std::vector<double>& logits, std::vector<double>& out) {
+        double maxLogit = *std::max_element(logits.begin(), logits.end());
+        double sum = 0.0;
+        for (size_t i = 0; i < logits.size(); ++i) { out[i] = std::exp(logits[i] - maxLogit); sum += out[i]; }
+        for (double& p : out) p /= sum;
+    }
+
+    static constexpr double PRETRAINED_EPSILON = 0.1;
+
+    AiAgent aiAgent_;
+    std::string dataDir_;
+    int epochs_;
+    std::string saveFile_;
+    int batchSize_;
+    std::vector<Slice> slices_;
+};
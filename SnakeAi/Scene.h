@@ -2,7 +2,7 @@
 
 #include <SFML/Graphics.hpp>
 
-enum class SceneAction { None, StartGame, Exit, ReturnToMenu };
+enum class SceneAction { None, StartGame, StartTiledGame, Exit, ReturnToMenu };
 
 class Scene {
 public:
@@ -0,0 +1,249 @@
+#pragma once
+#include "Core/MultiSnakeGame.h"
+#include "Core/AiAgent.h"
+#include "Core/TrainingConfig.h"
+#include "Core/ThreadPool.h"
+#include "Core/ReplayMemory.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Self-play on a shared board: every snake of a MultiSnakeGame is driven
+ * by the same network. Each tick extracts all observations in parallel into one
+ * batch and runs a single forward pass for it; every agent-step goes into one replay
+ * memory. A snake that dies ends its game and is respawned on the next tick;
+ * while the board has no free cell for it, it sits the tick out.
+ */
+class SelfPlayTrainer {
+public:
+    SelfPlayTrainer(int snakes, long long ticks, std::string loadFile, std::string saveFile,
+                    const TrainingConfig& config = TrainingConfig(), unsigned int seed = std::random_device{}())
+        : game_(snakes, config.boardRows, config.boardCols), aiAgent_(config, seed), rng_(seed + 1),
+          ticks_(ticks), loadFile_(std::move(loadFile)), saveFile_(std::move(saveFile)) {
+        if (game_.snakeCount() < snakes) {
+            std::cerr << "Error: " << snakes << " snakes and their food do not fit on a " << config.boardRows << "x" << config.boardCols
+                      << " board. Using " << game_.snakeCount() << " snakes." << std::endl;
+        }
+        game_.seed(seed);
+        game_.reset();
+        ThreadPool::configureShared(config.threads, config.pinThreads);
+    }
+
+    void run() {
+        std::cout << "--- Self-play: " << game_.snakeCount() << " snakes on " << game_.getRows() << "x" << game_.getCols()
+                  << " for " << ticks_ << " ticks ---" << std::endl;
+        if (!loadFile_.empty()) aiAgent_.load(loadFile_);
+        replay_ = std::make_unique<ReplayMemory>(ReplayMemory::settingsFor(aiAgent_.config));
+
+        const int count = game_.snakeCount();
+        const int inputs = AiAgent::stateSize(aiAgent_.config.features);
+        std::vector<double> states((size_t)count * inputs);
+        std::vector<sf::Vector2i> moves(count);
+        std::vector<sf::Vector2i> foodBefore(count);
+        std::vector<char> alive(count);
+
+        using Clock = std::chrono::steady_clock;
+        const auto start = Clock::now();
+        Clock::duration forwardTime{};
+        long long agentSteps = 0;
+        int pendingTrain = 0;
+
+        for (long long tick = 1; tick <= ticks_; ++tick) {
+            // A snake with no free cell to respawn on has no body and no move this tick
+            int living = 0;
+            for (int i = 0; i < count; ++i) {
+                game_.respawn(i);
+                alive[i] = game_.getSnake(i).alive;
+                living += alive[i];
+            }
+
+            // 1. Observe every snake into one batch
+            ThreadPool::shared().parallelFor(0, count, [&](size_t lo, size_t hi) {
+                for (size_t i = lo; i < hi; ++i) foodBefore[i] = observe((int)i, states.data() + i * inputs);
+            });
+            const auto forwardStart = Clock::now();
+            std::vector<int> actions = aiAgent_.getActions(states, count);
+            forwardTime += Clock::now() - forwardStart;
+
+            // 2. Move everyone at once
+            for (int i = 0; i < count; ++i) moves[i] = AiAgent::toDirection(actions[i], game_.getSnake(i).direction);
+            std::vector<sf::Vector2i> heads(count);
+            std::vector<int> lengths(count);
+            for (int i = 0; i < count; ++i) {
+                if (!alive[i]) continue;
+                heads[i] = game_.getSnake(i).body.front();
+                lengths[i] = (int)game_.getSnake(i).body.size();
+            }
+            const std::vector<MultiSnakeGame::Outcome> outcomes = game_.step(moves);
+
+            // 3. Rewards and replay
+            const TrainingConfig& cfg = aiAgent_.config;
+            for (int i = 0; i < count; ++i) {
+                if (!alive[i]) continue;
+                const bool died = outcomes[i] == MultiSnakeGame::Outcome::Died;
+                double reward = cfg.rewardStep;
+                if (died) {
+                    reward = cfg.rewardDeath;
+                } else if (outcomes[i] == MultiSnakeGame::Outcome::Ate) {
+                    reward = cfg.rewardFood;
+                } else if (foodBefore[i].x >= 0) {
+                    const sf::Vector2i next = heads[i] + moves[i];
+                    const int dPre = std::abs(heads[i].x - foodBefore[i].x) + std::abs(heads[i].y - foodBefore[i].y);
+                    const int dPost = std::abs(next.x - foodBefore[i].x) + std::abs(next.y - foodBefore[i].y);
+                    reward += (dPost < dPre) ? cfg.rewardCloser : cfg.rewardAway;
+                }
+
+                Experience exp;
+                exp.state.assign(states.begin() + (size_t)i * inputs, states.begin() + (size_t)(i + 1) * inputs);
+                exp.action = actions[i];
+                exp.reward = reward;
+                exp.done = died;
+                exp.nextState.resize(inputs);
+                if (!died) observe(i, exp.nextState.data());
+                replay_->push(exp);
+
+                if (died) finishGame(lengths[i]);
+            }
+
+            // Same ratio as HeadlessTrainer: one batch per five agent-steps
+            agentSteps += living;
+            for (pendingTrain += living; pendingTrain >= 5; pendingTrain -= 5) trainFromMemory();
+
+            if (tick % LOG_TICKS == 0 || tick == ticks_) {
+                const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+                const double forwardUs = std::chrono::duration<double, std::micro>(forwardTime).count();
+                char line[256];
+                std::snprintf(line, sizeof(line), "Tick: %lld | Games: %lld | Mean Score: %.2f | Best: %d | Agent-steps/s: %.0f | Forward: %.2f us/agent | Epsilon: %.4f",
+                              tick, games_, recentGames_ > 0 ? (double)recentScore_ / recentGames_ : 0.0, bestScore_,
+                              seconds > 0 ? agentSteps / seconds : 0.0, agentSteps > 0 ? forwardUs / agentSteps : 0.0, aiAgent_.epsilon);
+                std::cout << line << std::endl;
+                recentGames_ = 0;
+                recentScore_ = 0;
+            }
+        }
+
+        if (!saveFile_.empty()) aiAgent_.save(saveFile_);
+        replay_->flush();
+        std::cout << "--- Self-play Complete ---" << std::endl;
+    }
+
+private:
+    static constexpr long long LOG_TICKS = 1000;
+
+    // Writes snake i's features to out and returns the food they point at.
+    // The snake sees the food nearest its head; other snakes are obstacles.
+    sf::Vector2i observe(int i, double* out) const {
+        const MultiSnakeGame::Snake& snake = game_.getSnake(i);
+        if (!snake.alive) return {-1, -1};
+        const sf::Vector2i food = game_.nearestFood(snake.body.front());
+        const std::vector<double> state = AiAgent::getState(aiAgent_.config.features, game_.getGrid(), snake.body.front(),
+                                                            snake.body.back(), food, snake.direction, (int)snake.body.size());
+        std::copy(state.begin(), state.end(), out);
+        return food;
+    }
+
+    void finishGame(int score) {
+        games_++;
+        recentGames_++;
+        recentScore_ += score;
+        bestScore_ = std::max(bestScore_, score);
+        aiAgent_.decayEpsilon();
+    }
+
+    void trainFromMemory() {
+        replay_->sample(aiAgent_.config.batchSize, rng_, batch_);
+        aiAgent_.train(batch_);
+    }
+
+    MultiSnakeGame game_;
+    AiAgent aiAgent_;
+    std::unique_ptr<ReplayMemory> replay_;
+    std::vector<Experience> batch_;
+    std::mt19937 rng_;
+    long long ticks_;
+    std::string loadFile_;
+    std::string saveFile_;
+    long long games_ = 0;
+    int recentGames_ = 0;
+    long long recentScore_ = 0;
+    int bestScore_ = 0;
+};
+
+/**
+ * @brief Inference cost per agent-step on a shared board as the number of snakes
+ * grows, with one batched forward pass per tick and with one pass per snake.
+ * The networks are untrained and nothing is learned.
+ */
+class SelfPlayBenchmark {
+public:
+    SelfPlayBenchmark(std::vector<int> counts, int ticks, const TrainingConfig& config = TrainingConfig())
+        : counts_(std::move(counts)), ticks_(ticks), config_(config) {}
+
+    void run() {
+        std::cout << "--- Forward cost per agent-step (" << ticks_ << " ticks each) ---" << std::endl;
+        for (int count : counts_) {
+            const double batched = measure(count, true);
+            const double single = measure(count, false);
+            char line[160];
+            std::snprintf(line, sizeof(line), "%4d snakes | batched %7.0f ns/agent-step | one pass per snake %7.0f ns/agent-step",
+                          count, batched, single);
+            std::cout << line << std::endl;
+        }
+    }
+
+private:
+    double measure(int count, bool batched) {
+        AiAgent agent(config_, 7);
+        agent.epsilon = 0.0;
+        MultiSnakeGame game(count, config_.boardRows, config_.boardCols);
+        game.seed(7);
+        game.reset();
+        count = game.snakeCount();
+
+        const int inputs = AiAgent::stateSize(config_.features);
+        std::vector<double> states((size_t)count * inputs);
+        std::vector<double> single(inputs);
+        std::vector<int> actions(count);
+        std::vector<sf::Vector2i> moves(count);
+
+        using Clock = std::chrono::steady_clock;
+        Clock::duration elapsed{};
+        long long agentSteps = 0;
+        for (int tick = 0; tick < ticks_; ++tick) {
+            for (int i = 0; i < count; ++i) {
+                game.respawn(i);
+                const MultiSnakeGame::Snake& snake = game.getSnake(i);
+                if (!snake.alive) continue; // no free cell; its row keeps the last state
+                const std::vector<double> state = AiAgent::getState(config_.features, game.getGrid(), snake.body.front(), snake.body.back(),
+                                                                    game.nearestFood(snake.body.front()), snake.direction, (int)snake.body.size());
+                std::copy(state.begin(), state.end(), states.begin() + (size_t)i * inputs);
+            }
+
+            const auto start = Clock::now();
+            if (batched) {
+                actions = agent.getActions(states, count);
+            } else {
+                for (int i = 0; i < count; ++i) {
+                    single.assign(states.begin() + (size_t)i * inputs, states.begin() + (size_t)(i + 1) * inputs);
+                    actions[i] = agent.getAction(single);
+                }
+            }
+            elapsed += Clock::now() - start;
+            agentSteps += count;
+
+            for (int i = 0; i < count; ++i) moves[i] = AiAgent::toDirection(actions[i], game.getSnake(i).direction);
+            game.step(moves);
+        }
+        return std::chrono::duration<double, std::nano>(elapsed).count() / std::max(1LL, agentSteps);
+    }
+
+    std::vector<int> counts_;
+    int ticks_;
+    TrainingConfig config_;
+};
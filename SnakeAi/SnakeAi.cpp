@@ -2,15 +2,36 @@
 #include <SFML/Graphics.hpp>
 #endif
 #include <memory>
+#include <algorithm>
 #include <ctime>
 #include <string>
+#include <vector>
 #include <iostream>
 #include "Scene.h"
 #include "StartScene.h"
 #include "GameScene.h"
 #include "HeadlessTrainer.h"
+#include "ExpertBaseline.h"
+#include "PretrainPipeline.h"
+#include "SweepRunner.h"
+#include "PolicyEvaluator.h"
+#include "BoardBenchmark.h"
+#include "SelfPlayTrainer.h"
 #include "Core/Config.h"
 
+// "16,32,64" -> {16, 32, 64}
+static std::vector<int> parseIntList(const std::string& list)
+{
+    std::vector<int> values;
+    for (size_t pos = 0; pos < list.size();) {
+        size_t comma = list.find(',', pos);
+        if (comma == std::string::npos) comma = list.size();
+        values.push_back(std::stoi(list.substr(pos, comma - pos)));
+        pos = comma + 1;
+    }
+    return values;
+}
+
 int main(int argc, char* argv[])
 {
     srand(static_cast<unsigned>(time(NULL)));
@@ -25,20 +46,191 @@ int main(int argc, char* argv[])
         if (argc > 3) loadFile = argv[3];
         if (argc > 4) saveFile = argv[4];
 
-        HeadlessTrainer trainer(attempts, loadFile, saveFile);
+        TrainingConfig config;
+        if (argc > 5 && !config.loadFromFile(argv[5])) return 1;
+
+        HeadlessTrainer trainer(attempts, loadFile, saveFile, config);
+        trainer.run();
+        return 0;
+    }
+
+    // Benchmark the Hamiltonian-cycle expert
+    if (argc > 1 && std::string(argv[1]) == "--baseline") {
+        int games = 100;
+        if (argc > 2) games = std::stoi(argv[2]);
+
+        ExpertBaseline baseline(games);
+        baseline.run();
+        return 0;
+    }
+
+    // Score and decision latency of a model, optionally with rollout search (budget 0 = network only)
+    if (argc > 1 && std::string(argv[1]) == "--evaluate") {
+        int games = 20;
+        std::string modelFile = "model.txt";
+        RolloutPlanner::Settings planner;
+
+        if (argc > 2) games = std::stoi(argv[2]);
+        if (argc > 3) modelFile = argv[3];
+        if (argc > 4) planner.budgetMs = std::stod(argv[4]);
+        if (argc > 5) planner.workers = std::stoi(argv[5]);
+        if (argc > 6) planner.depth = std::stoi(argv[6]);
+
+        PolicyEvaluator evaluator(games, modelFile, planner);
+        evaluator.run();
+        return 0;
+    }
+
+    // Behaviour cloning: generate teacher demonstrations, then fit the network to them
+    if (argc > 1 && std::string(argv[1]) == "--generate-demos") {
+        long long samples = 1000000;
+        std::string outDir = "demos";
+        int workers = 0;
+
+        if (argc > 2) samples = std::stoll(argv[2]);
+        if (argc > 3) outDir = argv[3];
+        if (argc > 4) workers = std::stoi(argv[4]);
+
+        DemoGenerator generator(samples, outDir, workers);
+        generator.run();
+        return 0;
+    }
+
+    if (argc > 1 && std::string(argv[1]) == "--pretrain") {
+        std::string dataDir = "demos";
+        int epochs = 5;
+        std::string saveFile = "model.txt";
+        int batchSize = 1024;
+
+        if (argc > 2) dataDir = argv[2];
+        if (argc > 3) epochs = std::stoi(argv[3]);
+        if (argc > 4) saveFile = argv[4];
+        if (argc > 5) batchSize = std::stoi(argv[5]);
+
+        TrainingConfig config;
+        if (argc > 6 && !config.loadFromFile(argv[6])) return 1;
+
+        SupervisedTrainer trainer(dataDir, epochs, saveFile, batchSize, config);
+        trainer.run();
+        return 0;
+    }
+
+    // Hyperparameter sweep with successive halving, one trial per thread
+    if (argc > 1 && std::string(argv[1]) == "--sweep") {
+        std::string specFile = "sweep.cfg";
+        std::string resultsFile = "sweep_results.csv";
+
+        if (argc > 2) specFile = argv[2];
+        if (argc > 3) resultsFile = argv[3];
+
+        SweepRunner sweep(specFile, resultsFile);
+        sweep.run();
+        return 0;
+    }
+
+    // Decision cost against board size: --bench-boards [sizes e.g. 16,32,64,128] [steps]
+    if (argc > 1 && std::string(argv[1]) == "--bench-boards") {
+        std::vector<int> sizes = {16, 32, 64, 128};
+        int steps = 20000;
+
+        if (argc > 2) {
+            sizes = parseIntList(argv[2]);
+            for (int& size : sizes) size = std::max(4, size);
+        }
+        if (argc > 3) steps = std::stoi(argv[3]);
+
+        BoardBenchmark bench(sizes, steps);
+        bench.run();
+        return 0;
+    }
+
+    // Frozen inference copy of a checkpoint: --export-policy [model] [policy file]
+    if (argc > 1 && std::string(argv[1]) == "--export-policy") {
+        std::string modelFile = "model.txt";
+        std::string policyFile = "policy.bin";
+
+        if (argc > 2) modelFile = argv[2];
+        if (argc > 3) policyFile = argv[3];
+
+        AiAgent agent;
+        if (!agent.load(modelFile)) return 1;
+        bool saved = false;
+        if (!withCompiledPolicy(agent.config.layers, [&](auto& policy) {
+                saved = policy.compile(agent.brain, agent.config.features) && policy.save(policyFile);
+            })) {
+            std::cerr << "Error: No compiled policy for topology " << agent.config.topologyString() << std::endl;
+            return 1;
+        }
+        if (saved) std::cout << "Exported " << modelFile << " (" << agent.config.topologyString() << ") to " << policyFile << std::endl;
+        return saved ? 0 : 1;
+    }
+
+    // Single-state decision latency, network vs compiled policy: --bench-policy [model] [decisions] [policy file]
+    if (argc > 1 && std::string(argv[1]) == "--bench-policy") {
+        std::string modelFile = "model.txt";
+        int decisions = 1000000;
+        std::string policyFile;
+
+        if (argc > 2) modelFile = argv[2];
+        if (argc > 3) decisions = std::max(1, std::stoi(argv[3]));
+        if (argc > 4) policyFile = argv[4];
+
+        PolicyLatencyBenchmark bench(modelFile, policyFile, decisions);
+        return bench.run() ? 0 : 1;
+    }
+
+    // Several snakes sharing one board and one network: --self-play [snakes] [ticks] [load] [save] [config]
+    if (argc > 1 && std::string(argv[1]) == "--self-play") {
+        int snakes = 8;
+        long long ticks = 100000;
+        std::string loadFile = "model.txt";
+        std::string saveFile = "model.txt";
+
+        if (argc > 2) snakes = std::max(1, std::stoi(argv[2]));
+        if (argc > 3) ticks = std::stoll(argv[3]);
+        if (argc > 4) loadFile = argv[4];
+        if (argc > 5) saveFile = argv[5];
+
+        TrainingConfig config;
+        if (argc > 6 && !config.loadFromFile(argv[6])) return 1;
+
+        SelfPlayTrainer trainer(snakes, ticks, loadFile, saveFile, config);
         trainer.run();
         return 0;
     }
 
+    // Batched vs per-snake inference cost: --bench-snakes [counts e.g. 1,4,16,64] [ticks] [config]
+    if (argc > 1 && std::string(argv[1]) == "--bench-snakes") {
+        std::vector<int> counts = {1, 4, 16, 64};
+        int ticks = 2000;
+
+        if (argc > 2) {
+            counts = parseIntList(argv[2]);
+            for (int& count : counts) count = std::max(1, count);
+        }
+        if (argc > 3) ticks = std::stoi(argv[3]);
+
+        TrainingConfig config;
+        if (argc > 4 && !config.loadFromFile(argv[4])) return 1;
+
+        SelfPlayBenchmark bench(counts, ticks, config);
+        bench.run();
+        return 0;
+    }
+
 #ifdef HEADLESS_BUILD
     std::cout << "This binary was built in HEADLESS mode. Please use --headless flag." << std::endl;
     return 1;
 #else
+    // Optional size of the tiled population view: --tiles [boards]
+    int tiledBoards = Config::TILED_BOARDS;
+    if (argc > 2 && std::string(argv[1]) == "--tiles") tiledBoards = std::max(1, std::stoi(argv[2]));
+
     sf::RenderWindow window(sf::VideoMode(Config::WINDOW_WIDTH, Config::WINDOW_HEIGHT), Config::WINDOW_TITLE, sf::Style::Titlebar | sf::Style::Close);
     window.setFramerateLimit(60);
 
     // Initial Scene
-    std::unique_ptr<Scene> currentScene = std::make_unique<StartScene>(window.getSize(), "Previous: none");
+    std::unique_ptr<Scene> currentScene = std::make_unique<StartScene>(window.getSize(), "Previous: none", tiledBoards);
 
     sf::Clock clock;
 
@@ -69,9 +261,12 @@ int main(int argc, char* argv[])
             else if (action == SceneAction::StartGame) {
                 currentScene = std::make_unique<GameScene>(window.getSize());
             }
+            else if (action == SceneAction::StartTiledGame) {
+                currentScene = std::make_unique<GameScene>(window.getSize(), tiledBoards);
+            }
             else if (action == SceneAction::ReturnToMenu) {
                 std::string stats = currentScene->getStats();
-                currentScene = std::make_unique<StartScene>(window.getSize(), stats.empty() ? "No previous stats" : stats);
+                currentScene = std::make_unique<StartScene>(window.getSize(), stats.empty() ? "No previous stats" : stats, tiledBoards);
             }
         }
 
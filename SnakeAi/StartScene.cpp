@@ -2,7 +2,7 @@
 #include "EmbeddedAssets.h"
 #include <iostream>
 
-StartScene::StartScene(const sf::Vector2u& windowSize, const std::string& lastStatsText)
+StartScene::StartScene(const sf::Vector2u& windowSize, const std::string& lastStatsText, int tiledBoards)
 {
     // Load bundled font from memory
     if (!font_.loadFromMemory(GameFont_ttf, GameFont_ttf_len)) {
@@ -36,6 +36,16 @@ StartScene::StartScene(const sf::Vector2u& windowSize, const std::string& lastSt
     // center text inside button
     startText_.setPosition(startButton_.getPosition().x + 10.f, startButton_.getPosition().y + 8.f);
 
+    tiledButton_.setSize({btnW * 2.f + 20.f, btnH});
+    tiledButton_.setFillColor(sf::Color(80, 120, 200));
+    tiledButton_.setPosition(startButton_.getPosition().x, startButton_.getPosition().y + btnH + 20.f);
+
+    tiledText_.setFont(font_);
+    tiledText_.setString("Watch " + std::to_string(tiledBoards) + " Boards");
+    tiledText_.setCharacterSize(24);
+    tiledText_.setFillColor(sf::Color::Black);
+    tiledText_.setPosition(tiledButton_.getPosition().x + 10.f, tiledButton_.getPosition().y + 8.f);
+
     exitButton_.setSize({btnW, btnH});
     exitButton_.setFillColor(sf::Color(200, 80, 80));
     exitButton_.setPosition(windowSize.x * 0.5f + 10.f, windowSize.y * 0.5f);
@@ -53,6 +63,8 @@ void StartScene::handleEvent(const sf::Event& ev)
         const sf::Vector2f mousePos(static_cast<float>(ev.mouseButton.x), static_cast<float>(ev.mouseButton.y));
         if (startButton_.getGlobalBounds().contains(mousePos)) {
             action_ = SceneAction::StartGame;
+        } else if (tiledButton_.getGlobalBounds().contains(mousePos)) {
+            action_ = SceneAction::StartTiledGame;
         } else if (exitButton_.getGlobalBounds().contains(mousePos)) {
             action_ = SceneAction::Exit;
         }
@@ -73,6 +85,8 @@ void StartScene::draw(sf::RenderWindow& window)
     window.draw(statsLabel_);
     window.draw(startButton_);
     window.draw(startText_);
+    window.draw(tiledButton_);
+    window.draw(tiledText_);
     window.draw(exitButton_);
     window.draw(exitText_);
 }
@@ -3,10 +3,11 @@
 #include "Scene.h"
 #include <SFML/Graphics.hpp>
 #include <string>
+#include "Core/Config.h"
 
 class StartScene : public Scene {
 public:
-    StartScene(const sf::Vector2u& windowSize, const std::string& lastStatsText);
+    StartScene(const sf::Vector2u& windowSize, const std::string& lastStatsText, int tiledBoards = Config::TILED_BOARDS);
     void handleEvent(const sf::Event& ev) override;
     SceneAction update(sf::Time dt) override;
     void draw(sf::RenderWindow& window) override;
@@ -16,6 +17,8 @@ private:
     sf::Text statsLabel_;
     sf::RectangleShape startButton_;
     sf::Text startText_;
+    sf::RectangleShape tiledButton_;
+    sf::Text tiledText_;
     sf::RectangleShape exitButton_;
     sf::Text exitText_;
     SceneAction action_ = SceneAction::None;
@@ -0,0 +1,313 @@
+#pragma once
+#include "HeadlessTrainer.h"
+#include "Core/TrainingConfig.h"
+#include "Core/ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Hyperparameter sweep on one node.
+ * Every trial is an independent HeadlessTrainer (own config, own seed, no model
+ * file syncing) and trials run one per thread, by default one thread per CPU the
+ * process may use. Trials are single-threaded (threads = 1), so their evaluation
+ * games and batch slices never stack extra pool threads on top of the trials.
+ * Successive halving: all trials train for min_attempts games, are scored by
+ * greedy evaluation games, and only the best 1/eta continue with eta times the
+ * budget, up to max_attempts.
+ *
+ * Spec file ("key = value", '#' comments):
+ *   mode = grid | random       trials = 32 (random only)   seed = 1
+ *   workers = 0 (all CPUs)     min_attempts = 20   max_attempts = 540
+ *   eta = 3                    eval_games = 10
+ *   gamma = 0.8 | 0.9 | 0.95                  # list, one value per grid point
+ *   learning_rate = loguniform(0.0001, 0.01)  # random mode only
+ *   reward_death = uniform(-100, -10)         # random mode only
+ * Any other key is a TrainingConfig setting.
+ */
+class SweepRunner {
+public:
+    SweepRunner(std::string specFile, std::string resultsFile)
+        : specFile_(std::move(specFile)), resultsFile_(std::move(resultsFile)) {}
+
+    void run() {
+        if (!loadSpec()) return;
+        makeTrials();
+        if (trials_.empty()) {
+            std::cerr << "Error: Sweep spec " << specFile_ << " produced no trials" << std::endl;
+            return;
+        }
+
+        std::cout << "--- Sweep: " << trials_.size() << " trials on " << workers_ << " threads ---" << std::endl;
+        ThreadPool::configureShared(1, false); // before any trial creates the pool
+
+        std::vector<Trial*> alive;
+        for (auto& t : trials_) alive.push_back(&t);
+
+        int budget = std::min(minAttempts_, maxAttempts_);
+        for (int rung = 0; ; ++rung) {
+            runRung(alive, budget, rung);
+            std::sort(alive.begin(), alive.end(), [](const Trial* a, const Trial* b) { return a->evalScore > b->evalScore; });
+
+            std::cout << "Rung " << rung << " | Trials: " << alive.size()
+                      << " | Attempts: " << budget
+                      << " | Best: trial " << alive.front()->id << " (" << alive.front()->evalScore << ")" << std::endl;
+            writeResults();
+
+            if (alive.size() <= 1 || budget >= maxAttempts_) break;
+
+            // Successive halving: drop the worst trials and free their memory
+            const size_t keep = std::max<size_t>(1, (size_t)std::ceil(alive.size() / (double)eta_));
+            for (size_t i = keep; i < alive.size(); ++i) alive[i]->trainer.reset();
+            alive.resize(keep);
+            budget = (int)std::min<long long>(maxAttempts_, (long long)budget * eta_);
+        }
+
+        const Trial* best = alive.front();
+        std::cout << "--- Sweep Complete. Best trial " << best->id << " (" << best->evalScore << "): "
+                  << best->description << " ---" << std::endl;
+        std::cout << "Results written to " << resultsFile_ << std::endl;
+    }
+
+private:
+    struct Param {
+        enum class Kind { List, Uniform, LogUniform };
+        std::string key;
+        Kind kind = Kind::List;
+        std::vector<std::string> values;
+        double low = 0.0, high = 0.0;
+    };
+
+    struct Trial {
+        int id = 0;
+        TrainingConfig config;
+        std::vector<std::string> values; // one per param, for the results table
+        std::string description;
+        unsigned int seed = 0;
+        std::unique_ptr<HeadlessTrainer> trainer;
+        int rung = 0;
+        int attempts = 0;
+        double trainScore = 0.0;
+        double evalScore = 0.0;
+        double seconds = 0.0;
+    };
+
+    static std::string trim(const std::string& s) {
+        const size_t b = s.find_first_not_of(" \t\r\n");
+        if (b == std::string::npos) return "";
+        return s.substr(b, s.find_last_not_of(" \t\r\n") - b + 1);
+    }
+
+    bool loadSpec() {
+        std::ifstream ifs(specFile_);
+        if (!ifs.is_open()) {
+            std::cerr << "Error: Could not open sweep spec " << specFile_ << std::endl;
+            return false;
+        }
+
+        std::string line;
+        int lineNo = 0;
+        while (std::getline(ifs, line)) {
+            lineNo++;
+            line = trim(line.substr(0, line.find('#')));
+            if (line.empty()) continue;
+            const size_t eq = line.find('=');
+            if (eq == std::string::npos) {
+                std::cerr << specFile_ << ":" << lineNo << ": expected key = value" << std::endl;
+                return false;
+            }
+            const std::string key = trim(line.substr(0, eq));
+            const std::string value = trim(line.substr(eq + 1));
+
+            try {
+                if (key == "mode")              { randomMode_ = (value == "random"); continue; }
+                if (key == "trials")            { randomTrials_ = std::stoi(value); continue; }
+                if (key == "seed")              { seed_ = (unsigned int)std::stoul(value); continue; }
+                if (key == "workers")           { workers_ = std::stoi(value); continue; }
+                if (key == "min_attempts")      { minAttempts_ = std::max(1, std::stoi(value)); continue; }
+                if (key == "max_attempts")      { maxAttempts_ = std::max(1, std::stoi(value)); continue; }
+                if (key == "eta")               { eta_ = std::max(2, std::stoi(value)); continue; }
+                if (key == "eval_games")        { evalGames_ = std::max(1, std::stoi(value)); continue; }
+            } catch (const std::exception&) {
+                std::cerr << specFile_ << ":" << lineNo << ": invalid number '" << value << "'" << std::endl;
+                return false;
+            }
+
+            Param p;
+            p.key = key;
+            std::string args;
+            if (value.rfind("uniform(", 0) == 0 || value.rfind("loguniform(", 0) == 0) {
+                p.kind = value[0] == 'l' ? Param::Kind::LogUniform : Param::Kind::Uniform;
+                args = value.substr(value.find('(') + 1);
+                args = args.substr(0, args.find(')'));
+                const size_t comma = args.find(',');
+                try {
+                    p.low = std::stod(args.substr(0, comma));
+                    p.high = std::stod(args.substr(comma + 1));
+                } catch (const std::exception&) {
+                    std::cerr << specFile_ << ":" << lineNo << ": invalid range '" << value << "'" << std::endl;
+                    return false;
+                }
+                if (p.kind == Param::Kind::LogUniform && (p.low <= 0.0 || p.high <= 0.0)) {
+                    std::cerr << specFile_ << ":" << lineNo << ": loguniform bounds must be positive" << std::endl;
+                    return false;
+                }
+            } else {
+                std::istringstream iss(value);
+                std::string item;
+                while (std::getline(iss, item, '|')) p.values.push_back(trim(item));
+            }
+
+            // Validate the key and every listed value against TrainingConfig
+            TrainingConfig probe;
+            const std::string sample = p.values.empty() ? formatValue(probe, key, p.low) : "";
+            bool valid = p.values.empty() ? !sample.empty() : true;
+            for (const auto& v : p.values) valid = valid && probe.set(key, v);
+            if (!valid) {
+                std::cerr << specFile_ << ":" << lineNo << ": invalid setting '" << line << "'" << std::endl;
+                return false;
+            }
+            params_.push_back(p);
+        }
+
+        if (workers_ <= 0) workers_ = ThreadPool::availableCpus();
+        return true;
+    }
+
+    // Applies a sampled number, rounding it for integer settings. Returns the
+    // text that was applied, or "" if the key rejects it.
+    static std::string formatValue(TrainingConfig& config, const std::string& key, double value) {
+        std::ostringstream oss;
+        oss << value;
+        if (config.set(key, oss.str())) return oss.str();
+        const std::string rounded = std::to_string(std::llround(value));
+        return config.set(key, rounded) ? rounded : "";
+    }
+
+    void makeTrials() {
+        std::mt19937 rng(seed_);
+        if (randomMode_) {
+            for (int i = 0; i < randomTrials_; ++i) {
+                Trial t;
+                for (const auto& p : params_) {
+                    std::string v;
+                    if (p.kind == Param::Kind::List) {
+                        v = p.values[rng() % p.values.size()];
+                        t.config.set(p.key, v);
+                    } else {
+                        std::uniform_real_distribution<double> dist(p.kind == Param::Kind::LogUniform ? std::log(p.low) : p.low,
+                                                                    p.kind == Param::Kind::LogUniform ? std::log(p.high) : p.high);
+                        double x = dist(rng);
+                        v = formatValue(t.config, p.key, p.kind == Param::Kind::LogUniform ? std::exp(x) : x);
+                    }
+                    t.values.push_back(v);
+                }
+                addTrial(std::move(t), rng());
+            }
+            return;
+        }
+
+        // Grid: cartesian product of all lists
+        for (const auto& p : params_) {
+            if (p.kind != Param::Kind::List) {
+                std::cerr << "Error: '" << p.key << "' uses a range, which needs mode = random" << std::endl;
+                return;
+            }
+        }
+        std::vector<size_t> index(params_.size(), 0);
+        while (true) {
+            Trial t;
+            for (size_t i = 0; i < params_.size(); ++i) {
+                t.config.set(params_[i].key, params_[i].values[index[i]]);
+                t.values.push_back(params_[i].values[index[i]]);
+            }
+            addTrial(std::move(t), rng());
+
+            size_t i = 0;
+            while (i < params_.size() && ++index[i] == params_[i].values.size()) index[i++] = 0;
+            if (i == params_.size()) break;
+        }
+    }
+
+    void addTrial(Trial&& t, unsigned int seed) {
+        t.id = (int)trials_.size();
+        t.config.threads = 1; // the sweep's own threads are the parallelism
+        t.seed = seed;
+        for (size_t i = 0; i < params_.size(); ++i) {
+            if (i > 0) t.description += " ";
+            t.description += params_[i].key + "=" + t.values[i];
+        }
+        trials_.push_back(std::move(t));
+    }
+
+    void runRung(const std::vector<Trial*>& alive, int budget, int rung) {
+        std::atomic<size_t> next{0};
+        auto worker = [&]() {
+            for (size_t i = next++; i < alive.size(); i = next++) {
+                Trial& t = *alive[i];
+                auto start = std::chrono::steady_clock::now();
+                if (!t.trainer) {
+                    t.trainer = std::make_unique<HeadlessTrainer>(budget, "", "", t.config, t.seed);
+                    t.trainer->setVerbose(false);
+                }
+                t.trainScore = t.trainer->runAttempts(budget - t.trainer->attempts());
+                t.evalScore = t.trainer->evaluate(evalGames_);
+                t.attempts = t.trainer->attempts();
+                t.rung = rung;
+                t.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            }
+        };
+
+        std::vector<std::thread> threads;
+        const int count = std::min<int>(workers_, (int)alive.size());
+        for (int w = 0; w < count; ++w) threads.emplace_back(worker);
+        for (auto& th : threads) th.join();
+    }
+
+    void writeResults() const {
+        std::vector<const Trial*> sorted;
+        for (const auto& t : trials_) sorted.push_back(&t);
+        std::sort(sorted.begin(), sorted.end(), [](const Trial* a, const Trial* b) {
+            if (a->rung != b->rung) return a->rung > b->rung;
+            return a->evalScore > b->evalScore;
+        });
+
+        std::ofstream ofs(resultsFile_);
+        if (!ofs.is_open()) {
+            std::cerr << "Error: Could not write sweep results to " << resultsFile_ << std::endl;
+            return;
+        }
+        ofs << "trial,rung,attempts,eval_score,train_score,seconds,seed";
+        for (const auto& p : params_) ofs << "," << p.key;
+        ofs << "\n";
+        for (const Trial* t : sorted) {
+            ofs << t->id << "," << t->rung << "," << t->attempts << "," << t->evalScore << ","
+                << t->trainScore << "," << t->seconds << "," << t->seed;
+            for (const auto& v : t->values) ofs << ",\"" << v << "\"";
+            ofs << "\n";
+        }
+    }
+
+    std::string specFile_;
+    std::string resultsFile_;
+    std::vector<Param> params_;
+    std::vector<Trial> trials_;
+
+    bool randomMode_ = false;
+    int randomTrials_ = 16;
+    unsigned int seed_ = 1;
+    int workers_ = 0;
+    int minAttempts_ = 20;
+    int maxAttempts_ = 540;
+    int eta_ = 3;
+    int evalGames_ = 10;
+};
@@ -0,0 +1,45 @@
+#pragma once
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+
+// Minimal checks for the CTest executables: a failed check prints where and
+// what, and the test's main() returns the failure count.
+namespace test {
+    inline int& failures() {
+        static int count = 0;
+        return count;
+    }
+}
+
+#define CHECK(cond)                                                                             \
+    do {                                                                                        \
+        if (!(cond)) {                                                                          \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK(" #cond ") failed" << std::endl; \
+            test::failures()++;                                                                 \
+        }                                                                                       \
+    } while (0)
+
+#define CHECK_EQ(a, b)                                                                                               \
+    do {                                                                                                             \
+        const auto va = (a);                                                                                         \
+        const auto vb = (b);                                                                                         \
+        if (!(va == vb)) {                                                                                           \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": " #a " == " #b " failed (" << va << " vs " << vb << ")" << std::endl; \
+            test::failures()++;                                                                                      \
+        }                                                                                                            \
+    } while (0)
+
+#define CHECK_NEAR(a, b, tol)                                                                                        \
+    do {                                                                                                             \
+        const double va = (a);                                                                                       \
+        const double vb = (b);                                                                                       \
+        if (!(std::fabs(va - vb) <= (tol))) {                                                                        \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": |" #a " - " #b "| <= " #tol " failed (" << va << " vs " << vb << ")" << std::endl; \
+            test::failures()++;                                                                                      \
+        }                                                                                                            \
+    } while (0)
+
+#define TEST_RESULT()                                                                   \
+    (test::failures() == 0 ? (std::cout << "All checks passed" << std::endl, 0)         \
+                           : (std::cout << test::failures() << " check(s) failed" << std::endl, 1))
@@ -0,0 +1,187 @@
+// Throughput of the hot paths against stored baselines. A rate below
+// baseline * (1 - tolerance) fails the test.
+//
+//   perf_budgets <baselines file> [--record]
+//
+// --record measures and rewrites the baselines (do that on the machine the
+// budgets are for). Unoptimized builds are skipped: their rates mean nothing.
+#include "TestSupport.h"
+#include "Core/SnakeGame.h"
+#include "Core/AiAgent.h"
+#include "Core/CompiledPolicy.h"
+#include <chrono>
+#include <fstream>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+    const int SKIPPED = 77; // SKIP_RETURN_CODE in CMakeLists.txt
+    const int DANGER = 28;  // first danger flag in the ray features
+
+    // Best of a few runs of at least `seconds` each; `work` returns the units it did
+    template <typename Work>
+    double ratePerSecond(Work&& work, double seconds = 0.4, int runs = 3) {
+        double best = 0.0;
+        for (int r = 0; r < runs; ++r) {
+            long long units = 0;
+            const auto start = std::chrono::steady_clock::now();
+            double elapsed = 0.0;
+            do {
+                units += work();
+                elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            } while (elapsed < seconds);
+            best = std::max(best, units / elapsed);
+        }
+        return best;
+    }
+
+    std::vector<std::vector<double>> randomStates(int count, std::mt19937& rng) {
+        std::uniform_real_distribution<double> uniform(0.0, 1.0);
+        std::vector<std::vector<double>> states(count, std::vector<double>(AiAgent::STATE_SIZE));
+        for (auto& state : states) {
+            for (double& v : state) v = uniform(rng) < 0.5 ? 0.0 : uniform(rng); // about as sparse as ray features
+        }
+        return states;
+    }
+
+    // Environment steps with ray features, the trainer's per-step work minus the network
+    double gameSteps() {
+        SnakeGame game(25, 25);
+        game.seed(1);
+        game.reset();
+        sf::Vector2i direction = {1, 0};
+        return ratePerSecond([&] {
+            for (int i = 0; i < 1000; ++i) {
+                const auto& body = game.getSnakeBody();
+                const std::vector<double> state = AiAgent::getState(game.getGrid(), body.front(), body.back(), game.getFoodPos(), direction);
+                // First action whose danger flag (straight, left, right) is clear
+                int action = 0;
+                while (action < AiAgent::ACTION_COUNT - 1 && state[DANGER + action] > 0.5) ++action;
+                sf::Vector2i move = AiAgent::toDirection(action, direction);
+                if (!game.step(move) || game.getFoodPos().x == -1) {
+                    game.reset();
+                    move = {1, 0};
+                }
+                direction = move;
+            }
+            return 1000;
+        });
+    }
+
+    double forwardPasses() {
+        std::mt19937 rng(2);
+        const std::vector<std::vector<double>> states = randomStates(256, rng);
+        AiAgent agent(TrainingConfig(), 3);
+        double sink = 0.0;
+        const double rate = ratePerSecond([&] {
+            for (const auto& state : states) sink += agent.brain.feedForward(state)[0];
+            return (long long)states.size();
+        });
+        return sink == 12345.0 ? 0.0 : rate; // keeps the passes from being optimized away
+    }
+
+    double trainSamples() {
+        std::mt19937 rng(4);
+        const std::vector<std::vector<double>> states = randomStates(257, rng);
+        std::vector<Experience> batch;
+        for (int i = 0; i < 32; ++i) batch.push_back({states[i], i % 3, 0.1 * (i % 5), states[i + 1], i % 9 == 0});
+        TrainingConfig config;
+        config.learningRate = 0.001;
+        AiAgent agent(config, 5);
+        return ratePerSecond([&] {
+            agent.train(batch);
+            return (long long)batch.size();
+        });
+    }
+
+    double compiledDecisions() {
+        std::mt19937 rng(6);
+        const std::vector<std::vector<double>> states = randomStates(256, rng);
+        AiAgent agent(TrainingConfig(), 7);
+        auto policy = std::make_unique<CompiledPolicy<AiAgent::STATE_SIZE, 128, AiAgent::ACTION_COUNT>>();
+        policy->compile(agent.brain, FeatureSet::Rays);
+        long long sink = 0;
+        const double rate = ratePerSecond([&] {
+            for (const auto& state : states) sink += policy->act(state);
+            return (long long)states.size();
+        });
+        return sink < 0 ? 0.0 : rate;
+    }
+
+    bool readBaselines(const std::string& file, std::map<std::string, double>& out) {
+        std::ifstream ifs(file);
+        if (!ifs.is_open()) return false;
+        std::string line;
+        while (std::getline(ifs, line)) {
+            line = line.substr(0, line.find('#'));
+            const size_t eq = line.find('=');
+            if (eq == std::string::npos) continue;
+            std::string key = line.substr(0, eq);
+            key.erase(key.find_last_not_of(" \t") + 1);
+            key.erase(0, key.find_first_not_of(" \t"));
+            out[key] = std::strtod(line.c_str() + eq + 1, nullptr);
+        }
+        return true;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "usage: perf_budgets <baselines file> [--record]" << std::endl;
+        return 1;
+    }
+    const std::string file = argv[1];
+    const bool record = argc > 2 && std::string(argv[2]) == "--record";
+#ifndef NDEBUG
+    if (!record) {
+        std::cout << "Skipped: performance budgets only apply to optimized (NDEBUG) builds" << std::endl;
+        return SKIPPED;
+    }
+#endif
+
+    const std::vector<std::pair<std::string, double (*)()>> measures = {
+        {"game_steps_per_sec", gameSteps},
+        {"forward_passes_per_sec", forwardPasses},
+        {"train_samples_per_sec", trainSamples},
+        {"compiled_decisions_per_sec", compiledDecisions},
+    };
+
+    std::map<std::string, double> baselines;
+    if (!readBaselines(file, baselines) && !record) {
+        std::cerr << "Error: Could not read baselines " << file << std::endl;
+        return 1;
+    }
+    const double tolerance = baselines.count("tolerance") ? baselines["tolerance"] : 0.3;
+
+    std::map<std::string, double> measured;
+    for (const auto& [name, measure] : measures) {
+        measured[name] = measure();
+        if (record) {
+            std::printf("%-28s %12.0f /s\n", name.c_str(), measured[name]);
+            continue;
+        }
+        if (!baselines.count(name)) {
+            std::printf("%-28s %12.0f /s  (no baseline)\n", name.c_str(), measured[name]);
+            continue;
+        }
+        const double budget = baselines[name] * (1.0 - tolerance);
+        const bool ok = measured[name] >= budget;
+        std::printf("%-28s %12.0f /s  baseline %12.0f  budget %12.0f  %s\n", name.c_str(), measured[name], baselines[name], budget,
+                    ok ? "ok" : "REGRESSED");
+        CHECK(ok);
+    }
+
+    if (record) {
+        std::ofstream ofs(file, std::ios::trunc);
+        ofs << "# Throughput baselines for perf_budgets (optimized build), recorded with:\n"
+            << "#   perf_budgets " << file << " --record\n"
+            << "# A rate below baseline * (1 - tolerance) fails the test.\n"
+            << "tolerance = " << tolerance << "\n";
+        for (const auto& [name, measure] : measures) ofs << name << " = " << (long long)measured[name] << "\n";
+        std::cout << "Recorded " << file << std::endl;
+        return ofs ? 0 : 1;
+    }
+    return TEST_RESULT();
+}
@@ -0,0 +1,104 @@
+// Golden trajectories for fixed seeds: a change to the game rules, the food
+// placement, the teacher or the training step shows up as a different hash.
+// The golden values depend on the standard library's random distributions and
+// are only compared under libstdc++; elsewhere the runs are only checked for
+// reproducibility.
+#include "TestSupport.h"
+#include "Core/SnakeGame.h"
+#include "Core/HamiltonianSolver.h"
+#include "Core/Teacher.h"
+#include "Core/AiAgent.h"
+#include <cstdint>
+#include <vector>
+
+namespace {
+    struct Trajectory {
+        int steps = 0;
+        int score = 0;
+        uint64_t hash = 0xcbf29ce484222325ull; // FNV-1a over head, food and score per step
+        std::vector<Experience> experiences;
+    };
+
+    void mix(uint64_t& hash, int value) {
+        for (int b = 0; b < 4; ++b) hash = (hash ^ ((uint32_t)value >> (8 * b) & 0xFF)) * 0x100000001b3ull;
+    }
+
+    // The teacher (BFS to the food, Hamiltonian cycle otherwise) plays a seeded game
+    Trajectory playTeacher(unsigned int seed, int maxSteps) {
+        const int rows = 12, cols = 12;
+        SnakeGame game(rows, cols);
+        HamiltonianSolver expert(rows, cols);
+        game.seed(seed);
+        game.reset();
+        Trajectory t;
+        sf::Vector2i direction = {1, 0};
+        for (int step = 0; step < maxSteps; ++step) {
+            const auto& body = game.getSnakeBody();
+            const sf::Vector2i food = game.getFoodPos();
+            if (food.x == -1) break; // board full
+            Experience exp;
+            exp.state = AiAgent::getState(game.getGrid(), body.front(), body.back(), food, direction);
+            const sf::Vector2i move = teacherMove(game, expert);
+            if (move == sf::Vector2i(0, 0)) break;
+            exp.action = AiAgent::toAction(move, direction);
+            const int scoreBefore = game.getScore();
+            const bool alive = game.step(move);
+            direction = move;
+            exp.done = !alive;
+            exp.reward = !alive ? -50.0 : (game.getScore() != scoreBefore ? 20.0 : -0.05);
+            const auto& after = game.getSnakeBody();
+            exp.nextState = AiAgent::getState(game.getGrid(), after.front(), after.back(), game.getFoodPos(), direction);
+            t.experiences.push_back(std::move(exp));
+
+            t.steps++;
+            mix(t.hash, after.front().x);
+            mix(t.hash, after.front().y);
+            mix(t.hash, game.getFoodPos().x);
+            mix(t.hash, game.getFoodPos().y);
+            mix(t.hash, game.getScore());
+            if (!alive) break;
+        }
+        t.score = game.getScore();
+        return t;
+    }
+
+    // Q-values of the first state after training a seeded agent on the trajectory in order
+    std::vector<double> trainOn(const Trajectory& t, unsigned int seed) {
+        TrainingConfig config;
+        config.layers = {{AiAgent::STATE_SIZE, Activation::Linear}, {32, Activation::ReLU}, {AiAgent::ACTION_COUNT, Activation::Linear}};
+        config.learningRate = 0.001;
+        config.tdErrorClip = 1.0;
+        AiAgent agent(config, seed);
+        const size_t batch = 32;
+        for (size_t i = 0; i + batch <= t.experiences.size() && i < 64 * batch; i += batch) {
+            agent.train(std::vector<Experience>(t.experiences.begin() + i, t.experiences.begin() + i + batch));
+        }
+        return agent.brain.feedForward(t.experiences.front().state);
+    }
+}
+
+int main() {
+    const Trajectory a = playTeacher(2024, 4000);
+    const Trajectory b = playTeacher(2024, 4000);
+    const Trajectory other = playTeacher(2025, 4000);
+    CHECK_EQ(a.steps, b.steps);
+    CHECK_EQ(a.hash, b.hash);
+    CHECK(a.hash != other.hash);
+    CHECK(a.score > 20);
+
+    const std::vector<double> q1 = trainOn(a, 7);
+    const std::vector<double> q2 = trainOn(a, 7);
+    CHECK(q1 == q2);
+
+    std::printf("trajectory: steps %d score %d hash 0x%016llx\n", a.steps, a.score, (unsigned long long)a.hash);
+    std::printf("trained q: %.17g %.17g %.17g\n", q1[0], q1[1], q1[2]);
+#ifdef __GLIBCXX__
+    // Re-record from the printed lines only for an intended behaviour change
+    CHECK_EQ(a.steps, 265);
+    CHECK_EQ(a.score, 31);
+    CHECK_EQ(a.hash, 0x7b5d25cfcf9add1aull);
+    const double goldenQ[3] = {0.38601296704721078, 0.66282465886611408, 0.22963009049970717};
+    for (int i = 0; i < 3; ++i) CHECK_NEAR(q1[i], goldenQ[i], 1e-7); // room for FMA contraction
+#endif
+    return TEST_RESULT();
+}
@@ -0,0 +1,165 @@
+// Network math: backpropagated gradients against central finite differences,
+// and the alternative forward paths (batched, packed bits, compiled policy)
+// against feedForward().
+#include "TestSupport.h"
+#include "Core/SimpleNN.h"
+#include "Core/CompiledPolicy.h"
+#include "Core/WindowFeatures.h"
+#include <random>
+#include <vector>
+
+namespace {
+    NeuralNetwork makeNetwork(const std::vector<int>& sizes, Activation hidden, Activation output, unsigned int seed) {
+        NeuralNetwork net;
+        net.rng.seed(seed);
+        for (size_t i = 0; i < sizes.size(); ++i) {
+            net.addLayer(sizes[i], i + 1 == sizes.size() ? output : hidden);
+        }
+        return net;
+    }
+
+    std::vector<double> randomVector(int size, std::mt19937& rng) {
+        std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+        std::vector<double> v(size);
+        for (double& x : v) x = uniform(rng);
+        return v;
+    }
+
+    // 0.5 * sum (target - output)^2
+    double loss(const NeuralNetwork& net, const std::vector<double>& input, const std::vector<double>& target) {
+        NeuralNetwork::Workspace ws;
+        const std::vector<double>& out = net.forward(input, ws);
+        double sum = 0.0;
+        for (size_t i = 0; i < out.size(); ++i) sum += 0.5 * (target[i] - out[i]) * (target[i] - out[i]);
+        return sum;
+    }
+
+    // accumulateGradient() returns the update direction, i.e. minus dLoss/dParameter
+    void checkGradient(Activation hidden, Activation output, double tolerance) {
+        std::mt19937 rng(11);
+        NeuralNetwork net = makeNetwork({5, 7, 6, 3}, hidden, output, 3);
+        const std::vector<double> input = randomVector(5, rng);
+        const std::vector<double> target = randomVector(3, rng);
+
+        NeuralNetwork::Workspace ws;
+        NeuralNetwork::Gradient grad;
+        net.initGradient(grad);
+        const std::vector<double> out = net.forward(input, ws);
+        std::vector<double> errors(3);
+        for (int i = 0; i < 3; ++i) errors[i] = target[i] - out[i];
+        net.accumulateGradient(errors, ws, grad);
+
+        const double h = 1e-6;
+        auto numeric = [&](double& parameter) {
+            const double saved = parameter;
+            parameter = saved + h;
+            const double up = loss(net, input, target);
+            parameter = saved - h;
+            const double down = loss(net, input, target);
+            parameter = saved;
+            return (up - down) / (2 * h);
+        };
+        double worst = 0.0;
+        for (size_t l = 1; l < net.layers.size(); ++l) {
+            Layer& layer = net.layers[l];
+            for (int j = 0; j < layer.size; ++j) {
+                worst = std::max(worst, std::fabs(numeric(layer.biases[j]) + grad.biases[l][j]));
+                for (int k = 0; k < layer.prevSize; ++k) {
+                    worst = std::max(worst, std::fabs(numeric(layer.weights[j][k]) + grad.weights[l][(size_t)j * layer.prevSize + k]));
+                }
+            }
+        }
+        std::printf("gradient %s -> %s: worst error %.3g\n", activationName(hidden), activationName(output), worst);
+        CHECK(worst < tolerance);
+    }
+
+    // One backPropagate() step moves the weights by learningRate * accumulateGradient()
+    void checkSgdStep() {
+        std::mt19937 rng(5);
+        NeuralNetwork net = makeNetwork({6, 8, 3}, Activation::Tanh, Activation::Linear, 9);
+        NeuralNetwork copy = net;
+        const std::vector<double> input = randomVector(6, rng);
+        const std::vector<double> target = randomVector(3, rng);
+
+        NeuralNetwork::Workspace ws;
+        NeuralNetwork::Gradient grad;
+        copy.initGradient(grad);
+        const std::vector<double> out = copy.forward(input, ws);
+        std::vector<double> errors(3);
+        for (int i = 0; i < 3; ++i) errors[i] = target[i] - out[i];
+        copy.accumulateGradient(errors, ws, grad);
+        copy.applyGradient(grad);
+
+        net.feedForward(input);
+        net.backPropagate(target);
+        double worst = 0.0;
+        for (size_t l = 1; l < net.layers.size(); ++l) {
+            for (int j = 0; j < net.layers[l].size; ++j) {
+                worst = std::max(worst, std::fabs(net.layers[l].biases[j] - copy.layers[l].biases[j]));
+                for (int k = 0; k < net.layers[l].prevSize; ++k) {
+                    worst = std::max(worst, std::fabs(net.layers[l].weights[j][k] - copy.layers[l].weights[j][k]));
+                }
+            }
+        }
+        CHECK(worst < 1e-15);
+    }
+
+    void checkForwardPaths() {
+        std::mt19937 rng(21);
+        NeuralNetwork net = makeNetwork({WindowObservation::INPUT_SIZE, 32, 3}, Activation::ReLU, Activation::Linear, 4);
+
+        // Batched: same values as one pass per input, for small and large batches
+        for (int count : {1, 5, 16}) {
+            std::vector<double> inputs;
+            for (int i = 0; i < count; ++i) {
+                const std::vector<double> one = randomVector(WindowObservation::INPUT_SIZE, rng);
+                inputs.insert(inputs.end(), one.begin(), one.end());
+            }
+            const std::vector<double> batched = net.feedForwardBatch(inputs, count);
+            CHECK_EQ(batched.size(), (size_t)count * 3);
+            for (int i = 0; i < count; ++i) {
+                const std::vector<double> single = net.feedForward(std::vector<double>(inputs.begin() + (size_t)i * WindowObservation::INPUT_SIZE,
+                                                                                       inputs.begin() + (size_t)(i + 1) * WindowObservation::INPUT_SIZE));
+                for (int o = 0; o < 3; ++o) CHECK_NEAR(batched[(size_t)i * 3 + o], single[o], 1e-12);
+            }
+        }
+
+        // Packed bits and the compiled policy: same values / same argmax as the dense pass
+        auto policy = std::make_unique<CompiledPolicy<WindowObservation::INPUT_SIZE, 32, 3>>();
+        CHECK(policy->compile(net, FeatureSet::Window));
+        std::bernoulli_distribution bit(0.2);
+        for (int trial = 0; trial < 200; ++trial) {
+            WindowObservation obs;
+            for (int i = 0; i < WindowObservation::BITS; ++i) {
+                if (bit(rng)) obs.bits[i >> 6] |= 1ull << (i & 63);
+            }
+            const std::vector<double> extras = randomVector(WindowObservation::EXTRAS, rng);
+            std::copy(extras.begin(), extras.end(), obs.extras);
+            std::vector<double> dense;
+            obs.toDense(dense);
+
+            const std::vector<double> q = net.feedForward(dense);
+            const std::vector<double> bits = net.feedForwardBits(obs.bits, WindowObservation::BITS, obs.extras, WindowObservation::EXTRAS);
+            for (int o = 0; o < 3; ++o) CHECK_NEAR(bits[o], q[o], 1e-12);
+
+            const int greedy = (int)(std::max_element(q.begin(), q.end()) - q.begin());
+            std::vector<double> sorted = q;
+            std::sort(sorted.rbegin(), sorted.rend());
+            if (sorted[0] - sorted[1] > 1e-4) { // float weights may only disagree on near-ties
+                CHECK_EQ(policy->act(dense), greedy);
+                CHECK_EQ(policy->act(obs), greedy);
+            }
+        }
+    }
+}
+
+int main() {
+    checkGradient(Activation::Linear, Activation::Linear, 1e-7);
+    checkGradient(Activation::ReLU, Activation::Linear, 1e-7);
+    checkGradient(Activation::Tanh, Activation::Tanh, 1e-7);
+    // fasttanh backpropagates with tanh's derivative, which is within ~1e-3 of the approximation's
+    checkGradient(Activation::FastTanh, Activation::Linear, 1e-2);
+    checkSgdStep();
+    checkForwardPaths();
+    return TEST_RESULT();
+}
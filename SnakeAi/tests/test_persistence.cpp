@@ -0,0 +1,216 @@
+// Save/load round-trips: checkpoints, training configs, compiled policies, the
+// replay memory's spill file and per-worker schedule state. Files are written to the working directory.
+#include "TestSupport.h"
+#include "Core/AiAgent.h"
+#include "Core/TrainingConfig.h"
+#include "Core/CompiledPolicy.h"
+#include "Core/ReplayMemory.h"
+#include "Core/TrainingSchedule.h"
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+    std::vector<double> randomState(std::mt19937& rng) {
+        std::uniform_real_distribution<double> uniform(0.0, 1.0);
+        std::vector<double> state(AiAgent::STATE_SIZE);
+        for (double& v : state) v = uniform(rng);
+        return state;
+    }
+
+    TrainingConfig reluConfig() {
+        TrainingConfig config;
+        config.layers = {{AiAgent::STATE_SIZE, Activation::Linear}, {64, Activation::ReLU}, {AiAgent::ACTION_COUNT, Activation::Linear}};
+        config.learningRate = 0.001;
+        return config;
+    }
+
+    void checkCheckpoint() {
+        const std::string file = "persistence_model.txt";
+        std::mt19937 rng(1);
+        TrainingConfig config = reluConfig();
+        config.metricsFile = "pod-a.prom"; // runtime settings stay out of the shared file
+        config.threads = 3;
+        AiAgent trained(config, 3);
+        trained.epsilon = 0.25;
+        std::vector<Experience> batch;
+        for (int i = 0; i < 32; ++i) batch.push_back({randomState(rng), i % 3, (double)(i % 5), randomState(rng), i % 7 == 0});
+        trained.train(batch);
+        trained.save(file);
+
+        // A default agent takes the stored topology, weights and epsilon
+        AiAgent loaded(TrainingConfig(), 4);
+        CHECK(loaded.load(file));
+        CHECK_EQ(loaded.config.topologyString(), trained.config.topologyString());
+        CHECK_NEAR(loaded.epsilon, 0.25, 1e-9);
+        for (int i = 0; i < 20; ++i) {
+            const std::vector<double> state = randomState(rng);
+            CHECK(loaded.brain.feedForward(state) == trained.brain.feedForward(state)); // shortest round-trip text is exact
+        }
+
+        std::ifstream in(file);
+        std::stringstream contents;
+        contents << in.rdbuf();
+        in.close();
+        const std::string text = contents.str();
+        CHECK(text.find("metrics_file") == std::string::npos);
+        CHECK(text.find("threads") == std::string::npos);
+
+        // A truncated file is rejected and leaves the weights alone
+        std::ofstream(file, std::ios::trunc) << text.substr(0, text.size() / 2);
+        AiAgent untouched(reluConfig(), 5);
+        const std::vector<double> state = randomState(rng);
+        const std::vector<double> before = untouched.brain.feedForward(state);
+        CHECK(!untouched.load(file));
+        CHECK(untouched.brain.feedForward(state) == before);
+        std::remove(file.c_str());
+    }
+
+    void checkConfig() {
+        const std::string file = "persistence_config.cfg";
+        TrainingConfig config = reluConfig();
+        config.features = FeatureSet::Window;
+        config.layers.front().size = WindowObservation::INPUT_SIZE;
+        config.boardRows = 40;
+        config.gamma = 0.95;
+        config.replaySpillFile = "replay.bin";
+        config.schedule = ScheduleMode::Adaptive;
+        config.curriculumStart = 10;
+        config.scheduleFile = "schedule.txt";
+        config.pinThreads = true;
+        {
+            std::ofstream ofs(file);
+            config.write(ofs);
+        }
+        TrainingConfig loaded;
+        CHECK(loaded.loadFromFile(file));
+        std::ostringstream a, b;
+        config.write(a);
+        loaded.write(b);
+        CHECK_EQ(a.str(), b.str());
+        std::remove(file.c_str());
+    }
+
+    void checkCompiledPolicy() {
+        const std::string file = "persistence_policy.bin";
+        AiAgent agent(reluConfig(), 6);
+        auto policy = std::make_unique<CompiledPolicy<AiAgent::STATE_SIZE, 64, AiAgent::ACTION_COUNT>>();
+        CHECK(policy->compile(agent.brain, FeatureSet::Rays));
+        CHECK(policy->save(file));
+
+        auto loaded = std::make_unique<CompiledPolicy<AiAgent::STATE_SIZE, 64, AiAgent::ACTION_COUNT>>();
+        CHECK(loaded->load(file));
+        CHECK(loaded->features() == FeatureSet::Rays);
+        std::mt19937 rng(2);
+        for (int i = 0; i < 200; ++i) {
+            const std::vector<double> state = randomState(rng);
+            CHECK_EQ(loaded->act(state), policy->act(state));
+        }
+        auto otherShape = std::make_unique<CompiledPolicy<AiAgent::STATE_SIZE, 128, AiAgent::ACTION_COUNT>>();
+        CHECK(!otherShape->load(file));
+        std::remove(file.c_str());
+    }
+
+    void checkReplaySpill() {
+        const std::string file = "persistence_replay.bin";
+        std::remove(file.c_str());
+        ReplayMemory::Settings settings;
+        settings.capacity = 20000;
+        settings.hotCapacity = ReplayMemory::CHUNK_RECORDS;
+        settings.spillFile = file;
+        const long long total = 3 * ReplayMemory::CHUNK_RECORDS + 100; // ends inside a chunk
+        {
+            ReplayMemory memory(settings);
+            CHECK(memory.spilling());
+            for (long long i = 0; i < total; ++i) {
+                Experience exp;
+                exp.state.assign(AiAgent::STATE_SIZE, 0.5);
+                exp.state[0] = (double)(i % 2);
+                exp.nextState.assign(AiAgent::STATE_SIZE, 0.25);
+                exp.reward = (double)i; // a float holds these exactly
+                exp.action = (int)(i % 3);
+                exp.done = i % 2 == 0;
+                memory.push(exp);
+            }
+        } // flushed on destruction
+
+        ReplayMemory reopened(settings);
+        CHECK_EQ(reopened.pushed(), total);
+        CHECK_EQ(reopened.size(), total);
+        std::mt19937 rng(3);
+        std::vector<Experience> batch;
+        for (int round = 0; round < 50; ++round) {
+            reopened.sample(64, rng, batch);
+            CHECK_EQ(batch.size(), (size_t)64);
+            for (const Experience& exp : batch) {
+                const long long i = (long long)exp.reward;
+                CHECK(i >= 0 && i < total);
+                CHECK_EQ(exp.action, (int)(i % 3));
+                CHECK_EQ(exp.done, i % 2 == 0);
+                CHECK_EQ(exp.state[0], (double)(i % 2));
+                CHECK_EQ(exp.nextState[1], 0.25);
+            }
+        }
+        std::remove(file.c_str());
+    }
+
+    void checkSchedule() {
+        const std::string file = "persistence_schedule.txt";
+        TrainingConfig config = reluConfig();
+        config.schedule = ScheduleMode::Adaptive;
+        config.scheduleWindow = 2;
+        config.schedulePatience = 1;
+        config.curriculumStart = 10;
+        config.curriculumPromote = 0.5;
+        config.minLearningRate = 0.0;
+
+        TrainingSchedule schedule(config);
+        CHECK_EQ(schedule.boardRows(), 10);
+        schedule.adoptEpsilon(0.05);
+        CHECK(!schedule.endGame());
+        CHECK(schedule.endGame()); // a window is due every scheduleWindow games
+        CHECK(schedule.endWindow(0.0) == TrainingSchedule::Event::None); // first window sets the best mean
+        for (int i = 0; i < 5; ++i) {
+            schedule.endGame();
+            schedule.endGame();
+            // A network that cannot play yet stays on the small board, however long it is flat
+            CHECK(schedule.endWindow(0.0) == TrainingSchedule::Event::Plateau);
+        }
+        CHECK_EQ(schedule.boardRows(), 10);
+        CHECK_NEAR(schedule.epsilon(), config.epsilonBoost, 1e-12);
+        CHECK(schedule.endWindow(50.0) == TrainingSchedule::Event::Promoted); // half of 10x10
+        CHECK_EQ(schedule.boardRows(), 15);
+        CHECK(schedule.endWindow(60.0) == TrainingSchedule::Event::None); // below half of 15x15
+        schedule.endWindow(200.0);
+        schedule.endWindow(200.0);
+        CHECK_EQ(schedule.boardCols(), 25);
+        CHECK(schedule.save(file));
+
+        // A restarted worker resumes the saved state instead of the configured start
+        TrainingSchedule resumed(config);
+        CHECK(resumed.load(file));
+        CHECK_EQ(resumed.boardRows(), 25);
+        CHECK_EQ(resumed.state().games, schedule.state().games);
+        CHECK_EQ(resumed.epsilon(), schedule.epsilon());
+        const double learningRate = resumed.learningRate();
+        resumed.endWindow(50.0);
+        CHECK(resumed.endWindow(50.0) == TrainingSchedule::Event::Plateau); // full board: plateau lowers the learning rate
+        CHECK_NEAR(resumed.learningRate(), learningRate * config.lrDecay, 1e-12);
+
+        std::ofstream(file, std::ios::trunc) << "epsilon = 2\n";
+        CHECK(!TrainingSchedule(config).load(file));
+        std::remove(file.c_str());
+    }
+}
+
+int main() {
+    checkCheckpoint();
+    checkConfig();
+    checkCompiledPolicy();
+    checkReplaySpill();
+    checkSchedule();
+    return TEST_RESULT();
+}